@@ -1,7 +1,21 @@
 #include "pch.hpp"
 #include "audio.hpp"
+#include "diagnostics.hpp"
 #include "renderer.hpp"
 #include "game.hpp"
+#include "matchhistory.hpp"
+#include "recorder.hpp"
+#include "replay.hpp"
+#include "scheduler.hpp"
+#include "stateexport.hpp"
+#include "taskgraph.hpp"
+#include "telemetry.hpp"
+#include "triplebuffer.hpp"
+
+#include <cassert>
+#include <ppltasks.h>
+#include <random>
+#include <thread>
 
 using namespace std::chrono;
 using namespace winrt;
@@ -14,6 +28,7 @@ using namespace Windows::ApplicationModel::Core;
 using namespace Windows::Foundation;
 using namespace Windows::Gaming::Input;
 using namespace Windows::Graphics::Display;
+using namespace Windows::Storage;
 using namespace Windows::System;
 using namespace Windows::UI;
 using namespace Windows::UI::Core;
@@ -30,11 +45,47 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView> {
 		CoreApplication::LeavingBackground({ this, &App::OnLeavingBackground });
 		Gamepad::GamepadAdded({ this, &App::OnGamepadAdded });
 		Gamepad::GamepadRemoved({ this, &App::OnGamepadRemoved });
-		renderer = std::make_unique<Renderer>();
-		audio = std::make_unique<Audio>();
-		game = std::make_unique<Game>(*audio);
+		// Build the independent subsystems in parallel. The first frame only needs the game and the renderer, so the
+		// audio engine and the sounds finish in the background while the game stays silent until they are ready. The
+		// sounds are only played by the game, so they also wait for it.
+		const auto localFolder = std::wstring(ApplicationData::Current().LocalFolder().Path());
+		const auto gameTask = startup.add("game", [this, localFolder] {
+			#if !defined(PONG_NO_TELEMETRY)
+			Telemetry::start((localFolder + L"\\telemetry.bin").c_str());
+			#endif
+			const auto seed = std::random_device{}();
+			game = std::make_unique<Game>(seed);
+			replaySession = std::make_unique<Replay::Session>(localFolder + L"\\session.bin", seed);
+			stateExport = std::make_unique<StateExport::Writer>();
+			matchHistory = std::make_unique<MatchHistory::File>((localFolder + L"\\history.bin").c_str(), MatchHistory::File::Mode::APPEND);
+			if (matchHistory->isOpen()) {
+				game->setMatchHistory(matchHistory.get());
+			}
+		});
+		const auto rendererTask = startup.add("renderer", [this] {
+			renderer = std::make_unique<Renderer>();
+		});
+		const auto audioTask = startup.add("audio", [this] {
+			audio = std::make_unique<Audio>();
+		});
+		startup.add("sounds", [this] {
+			auto sound = audio->createSound(L"Assets/beep.wav");
+			critical_section::scoped_lock lock{ gameLock };
+			beepSound = std::move(sound);
+		}, { gameTask, audioTask });
+		startup.start();
+		startup.wait(gameTask);
+		startup.wait(rendererTask);
 	}
 
+	#if defined(_DEBUG)
+	void ReportStartup() {
+		// The first frame is the last phase of the startup the user waits for.
+		startup.mark("first frame");
+		OutputDebugStringA(("startup\n" + startup.formatReport()).c_str());
+	}
+	#endif
+
 	void OnActivated(const CoreApplicationView&, const IActivatedEventArgs&) {
 		auto window = CoreWindow::GetForCurrentThread();
 		window.Activate();
@@ -47,6 +98,7 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView> {
 
 	void OnLeavingBackground(const IInspectable&, const LeavingBackgroundEventArgs&) {
 		foreground = true;
+		redrawRequested = true;
 	}
 
 	void Load(const hstring&) {
@@ -54,40 +106,220 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView> {
 	}
 
 	void Uninitialize() {
-		// nothing...
+		startup.waitAll();
+		running = false;
+		if (simulationThread.joinable()) {
+			simulationThread.join();
+		}
+		Telemetry::stop();
 	}
 
 	void Run() {
-		auto previousTime = system_clock::now();
+		// Cap the frame rate in case the swap chain does not block us e.g. when the window is occluded.
+		constexpr auto MaxFrameRate = 240.0;
+		auto clock = SteadyClock{};
+		auto scheduler = FrameScheduler{ clock, MaxFrameRate };
+		dispatcher = CoreWindow::GetForCurrentThread().Dispatcher();
+		simulationThread = std::thread(&App::Simulate, this);
 		while (true) {
-			auto window = CoreWindow::GetForCurrentThread();
-			auto dispatcher = window.Dispatcher();
 			if (foreground) {
+				// Block on the dispatcher while the game shows a static screen that has already been drawn.
+				if (idle && !redrawRequested.exchange(false)) {
+					WaitForEvents();
+					continue;
+				}
 				dispatcher.ProcessEvents(CoreProcessEventsOption::ProcessAllIfPresent);
 
-				// Read gamepad readings.
-				ReadGamepads();
-
-				// Resolve the duration of the previous frame and ensure that we stay within reasonable limits.
-				const static auto MaxFrameTime = 250ms;
-				const auto currentTime = system_clock::now();
-				auto frameTime = currentTime - previousTime;
-				if (frameTime > MaxFrameTime) {
-					frameTime = MaxFrameTime;
-				}
-				previousTime = currentTime;
+				// Wait until the swap chain and the scheduler allow us to start a new frame.
+				renderer->waitForFrame();
+				scheduler.waitForNextFrame();
 
-				// Update game world by the amount of time passed and render the game scene.
-				game->update(duration_cast<milliseconds>(frameTime));
+				// Render the newest scene completed by the simulation thread.
+				const auto countersBefore = Diagnostics::getCounters();
 				renderer->clear();
-				game->render(*renderer);
-				renderer->present();
+				renderer->draw(scenes.read());
+				if (!renderer->present()) {
+					redrawRequested = true;
+				}
+				CountFrameOperations(countersBefore, Diagnostics::getCounters());
+				#if defined(_DEBUG)
+				if (!startupReported) {
+					ReportStartup();
+					startupReported = true;
+				}
+				ReportStatistics(L"frame", scheduler);
+				ReportResizeStatistics();
+				#endif
 			} else {
 				dispatcher.ProcessEvents(CoreProcessEventsOption::ProcessOneAndAllPending);
 			}
 		}
 	}
 
+	void WaitForEvents() {
+		// Measure the processor time the whole process spends while the renderer is blocked.
+		const auto idleStart = steady_clock::now();
+		const auto processorTimeStart = GetProcessorTime();
+		dispatcher.ProcessEvents(CoreProcessEventsOption::ProcessOneAndAllPending);
+		idleStatistics.wakeUps++;
+		idleStatistics.idleTime += steady_clock::now() - idleStart;
+		idleStatistics.processorTime += GetProcessorTime() - processorTimeStart;
+		if (const auto requestTime = wakeRequestTime.exchange(0)) {
+			idleStatistics.wakeLatency += steady_clock::now().time_since_epoch() - Clock::Duration(requestTime);
+			idleStatistics.simulationWakeUps++;
+		}
+		#if defined(_DEBUG)
+		if (!idle) {
+			ReportIdleStatistics();
+		}
+		#endif
+	}
+
+	void WakeRenderer() {
+		wakeRequestTime = steady_clock::now().time_since_epoch().count();
+		redrawRequested = true;
+		dispatcher.RunAsync(CoreDispatcherPriority::High, [] {});
+	}
+
+	static auto GetProcessorTime() -> Clock::Duration {
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+			return Clock::Duration::zero();
+		}
+		const auto toTicks = [](const FILETIME& t) { return (static_cast<long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+		return duration<long long, std::ratio<1, 10'000'000>>(toTicks(kernelTime) + toTicks(userTime));
+	}
+
+	void ReportIdleStatistics() {
+		const auto toMS = [](Clock::Duration d) { return duration<double, std::milli>(d).count(); };
+		const auto& stats = idleStatistics;
+		const auto latency = stats.simulationWakeUps > 0 ? toMS(stats.wakeLatency) / stats.simulationWakeUps : 0.0;
+		const auto cpu = stats.idleTime.count() > 0 ? 100.0 * stats.processorTime.count() / stats.idleTime.count() : 0.0;
+		wchar_t message[160];
+		swprintf_s(message, L"idle time=%.1fms cpu=%.2f%% wakeups=%lld latency=%.3fms\n", toMS(stats.idleTime), cpu, stats.wakeUps, latency);
+		OutputDebugStringW(message);
+		idleStatistics = {};
+	}
+
+	void Simulate() {
+		constexpr auto SimulationRate = 120.0;
+		constexpr auto BackgroundSleepTime = 100ms;
+		constexpr auto IdlePollInterval = 50ms;
+		constexpr auto MaxFrameTime = 250ms;
+		auto clock = SteadyClock{};
+		auto scheduler = FrameScheduler{ clock, SimulationRate };
+		auto pendingTime = Clock::Duration::zero();
+		Telemetry::registerThread();
+		while (running) {
+			if (!foreground) {
+				clock.sleep(BackgroundSleepTime);
+				continue;
+			}
+
+			// Only poll the gamepads at a low rate while the game shows a static screen. Key presses wake us at once.
+			if (idle) {
+				simulationWake.wait(static_cast<unsigned int>(IdlePollInterval.count()));
+				simulationWake.reset();
+			}
+
+			// Resolve the duration of the previous step and ensure that we stay within reasonable limits.
+			auto stepTime = scheduler.waitForNextFrame();
+			if (stepTime > MaxFrameTime) {
+				stepTime = MaxFrameTime;
+			}
+
+			// Carry the sub-millisecond remainder over to the next step so no simulation time gets lost.
+			pendingTime += stepTime;
+			const auto delta = duration_cast<milliseconds>(pendingTime);
+			pendingTime -= delta;
+
+			// Update game world by the amount of time passed and publish a snapshot of it for the renderer.
+			auto& scene = scenes.getWriteBuffer();
+			auto isStatic = false;
+			{
+				critical_section::scoped_lock lock{ gameLock };
+				const auto countersBefore = Diagnostics::getCounters();
+				const auto input = ReadInput();
+				game->onInput(input);
+				game->update(delta);
+				PlaySounds();
+				scene.clear();
+				game->render(scene);
+				isStatic = game->isStatic();
+
+				// Record the step so that the session can be saved as a replay.
+				replaySession->record(*game, input, delta);
+
+				// Let the local tools know about the new state.
+				if (stateExport->isOpen()) {
+					stateExport->publish(game->getMatchState());
+				}
+
+				// The steady state simulation step must not touch the heap or reference counts, from reading the input to
+				// publishing the state.
+				const auto countersAfter = Diagnostics::getCounters();
+				assert(countersAfter.allocations == countersBefore.allocations);
+				assert(countersAfter.referenceOperations == countersBefore.referenceOperations);
+			}
+			scenes.publish();
+
+			// Let the renderer know when it may stop or has to resume drawing frames.
+			if (isStatic != idle) {
+				idle = isStatic;
+				WakeRenderer();
+			}
+			#if defined(_DEBUG)
+			ReportStatistics(L"simulation step", scheduler);
+			#endif
+		}
+	}
+
+	void ReportStatistics(const wchar_t* name, FrameScheduler& scheduler) {
+		constexpr auto ReportInterval = 600;
+		const auto stats = scheduler.getStatistics();
+		if (stats.frames >= ReportInterval) {
+			const auto toMS = [](Clock::Duration d) { return duration<double, std::milli>(d).count(); };
+			wchar_t message[160];
+			swprintf_s(message, L"%s rate=%.1fHz avg=%.3fms jitter=%.3fms min=%.3fms max=%.3fms\n",
+				name, 1000.0 / toMS(stats.average), toMS(stats.average), toMS(stats.jitter), toMS(stats.minimum), toMS(stats.maximum));
+			OutputDebugStringW(message);
+			scheduler.resetStatistics();
+		}
+	}
+
+	void CountFrameOperations(const Diagnostics::Counters& before, const Diagnostics::Counters& after) {
+		// Frames that rebuild resources e.g. after a resize or for new glyphs may allocate, other frames may not.
+		const auto allocations = after.allocations - before.allocations;
+		const auto referenceOperations = after.referenceOperations - before.referenceOperations;
+		frameCounters.frames++;
+		frameCounters.allocations += allocations;
+		frameCounters.referenceOperations += referenceOperations;
+		if (allocations > 0 || referenceOperations > 0) {
+			frameCounters.busyFrames++;
+		}
+		#if defined(_DEBUG)
+		constexpr auto ReportInterval = 600;
+		if (frameCounters.frames >= ReportInterval) {
+			wchar_t message[160];
+			swprintf_s(message, L"frame allocations=%llu references=%llu busy frames=%llu/%llu\n", frameCounters.allocations,
+				frameCounters.referenceOperations, frameCounters.busyFrames, frameCounters.frames);
+			OutputDebugStringW(message);
+			frameCounters = {};
+		}
+		#endif
+	}
+
+	void ReportResizeStatistics() {
+		const auto& stats = renderer->getResizeStatistics();
+		if (stats.resizes != reportedResizes) {
+			wchar_t message[128];
+			swprintf_s(message, L"resize requests=%lld resizes=%lld stall=%.3fms\n",
+				stats.requests, stats.resizes, duration<double, std::milli>(stats.stallTime).count());
+			OutputDebugStringW(message);
+			reportedResizes = stats.resizes;
+		}
+	}
+
 	void SetWindow(const CoreWindow& window) {
 		window.SizeChanged({ this, &App::OnWindowSizeChanged });
 		window.KeyDown({ this, &App::OnKeyDown });
@@ -100,23 +332,102 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView> {
 
 	void OnWindowSizeChanged(const CoreWindow& window, const WindowSizeChangedEventArgs&) {
 		renderer->setWindowSize(Size(window.Bounds().Width, window.Bounds().Height));
+		redrawRequested = true;
 	}
 
 	void OnDisplayContentsInvalidated(const DisplayInformation&, const IInspectable&) {
 		renderer->initDeviceResources();
 		renderer->initWindowResources();
+		redrawRequested = true;
 	}
 
 	void OnDPIChanged(const DisplayInformation& info, const IInspectable&) {
 		renderer->setDpi(info.LogicalDpi());
+		redrawRequested = true;
 	}
 
 	void OnKeyDown(const CoreWindow&, const KeyEventArgs& args) {
-		game->onKeyDown(args);
+		if (args.VirtualKey() == VirtualKey::F9) {
+			ToggleRecording();
+			return;
+		}
+		if (args.VirtualKey() == VirtualKey::F10) {
+			SaveReplay();
+			return;
+		}
+
+		// The keys are collected into the input of the next simulation step. The last pressed direction wins.
+		{
+			critical_section::scoped_lock lock{ gameLock };
+			switch (args.VirtualKey()) {
+			case VirtualKey::Up:
+				keyboardInput.player2Movement = -1;
+				break;
+			case VirtualKey::Down:
+				keyboardInput.player2Movement = 1;
+				break;
+			case VirtualKey::W:
+				keyboardInput.player1Movement = -1;
+				break;
+			case VirtualKey::S:
+				keyboardInput.player1Movement = 1;
+				break;
+			case VirtualKey::X:
+				keyboardInput.start = true;
+				break;
+			}
+		}
+		simulationWake.set();
 	}
 
 	void OnKeyUp(const CoreWindow&, const KeyEventArgs& args) {
-		game->onKeyUp(args);
+		{
+			critical_section::scoped_lock lock{ gameLock };
+			auto& input = keyboardInput;
+			switch (args.VirtualKey()) {
+			case VirtualKey::Up:
+				input.player2Movement = std::max<int8_t>(0, input.player2Movement);
+				break;
+			case VirtualKey::Down:
+				input.player2Movement = std::min<int8_t>(0, input.player2Movement);
+				break;
+			case VirtualKey::W:
+				input.player1Movement = std::max<int8_t>(0, input.player1Movement);
+				break;
+			case VirtualKey::S:
+				input.player1Movement = std::min<int8_t>(0, input.player1Movement);
+				break;
+			}
+		}
+		simulationWake.set();
+	}
+
+	void SaveReplay() {
+		// The session is already streamed into a file, so the lock is only held to hand over the latest steps. The file
+		// is copied in the background as the session keeps going.
+		const auto timestamp = system_clock::now().time_since_epoch().count();
+		const auto filename = std::filesystem::path(std::wstring(ApplicationData::Current().LocalFolder().Path() + L"\\replay-" + to_hstring(timestamp) + L".bin"));
+		critical_section::scoped_lock lock{ gameLock };
+		replaySession->save(filename);
+	}
+
+	void ToggleRecording() {
+		constexpr auto RecordingFrameRate = 60;
+		if (recorder) {
+			renderer->setRecorder(nullptr);
+			recorder->finish(Recorder::Clock::now());
+			#if defined(_DEBUG)
+			wchar_t message[128];
+			swprintf_s(message, L"recording stopped encoded=%lld dropped=%lld duplicated=%lld\n", recorder->getEncodedFrames(), recorder->getDroppedFrames(), recorder->getDuplicatedFrames());
+			OutputDebugStringW(message);
+			#endif
+			recorder = nullptr;
+		} else {
+			const auto timestamp = system_clock::now().time_since_epoch().count();
+			const auto filename = ApplicationData::Current().LocalFolder().Path() + L"\\capture-" + to_hstring(timestamp) + L".y4m";
+			recorder = std::make_unique<Recorder>(filename.c_str(), RecordingFrameRate);
+			renderer->setRecorder(recorder.get());
+		}
 	}
 
 	void OnGamepadAdded(const IInspectable&, const Gamepad& gamepad) {
@@ -138,21 +449,80 @@ struct App : implements<App, IFrameworkViewSource, IFrameworkView> {
 		}
 	}
 
-	void ReadGamepads() {
+	auto ReadInput() -> Game::Input {
+		// A key press starts a game only once, while a gamepad starts a game for as long as its button is held down.
+		auto input = keyboardInput;
+		keyboardInput.start = false;
+
+		// A connected gamepad overrides the keys of its player.
+		constexpr auto DeadZone = .25f;
 		critical_section::scoped_lock lock{ gamepadLock };
 		for (auto i = 0; i < gamepads.size(); i++) {
-			auto reading = gamepads[i].GetCurrentReading();
-			game->onReadGamepad(i, reading);
+			const auto reading = gamepads[i].GetCurrentReading();
+			const auto y = reading.LeftThumbstickY;
+			const auto movement = static_cast<int8_t>(y > DeadZone ? -1 : y < -DeadZone ? 1 : 0);
+			(i == 0 ? input.player1Movement : input.player2Movement) = movement;
+			if (GamepadButtons::X == (reading.Buttons & GamepadButtons::X)) {
+				input.start = true;
+			}
+		}
+		return input;
+	}
+
+	void PlaySounds() {
+		// Start the sounds of the step at their offsets within the step. This delays every sound by one step but keeps
+		// their onsets aligned with the moments of the impacts instead of the step boundaries. Sounds are loaded in the
+		// background so they may not be available yet.
+		for (const auto& event : game->getSoundEvents()) {
+			if (event.sound == Game::Sound::BEEP && beepSound.isLoaded()) {
+				beepSound.play(event.delayMS);
+			}
 		}
 	}
 
 private:
-	bool                      foreground = false;
-	std::unique_ptr<Renderer> renderer;
-	std::unique_ptr<Audio>    audio;
-	std::unique_ptr<Game>     game;
-	critical_section          gamepadLock;
-	std::vector<Gamepad>      gamepads;
+	struct IdleStatistics {
+		long long       wakeUps = 0;
+		long long       simulationWakeUps = 0;
+		Clock::Duration idleTime = {};
+		Clock::Duration processorTime = {};
+		Clock::Duration wakeLatency = {};
+	};
+
+	// FrameCounters sums up the heap allocations and reference count operations of the rendered frames.
+	struct FrameCounters {
+		uint64_t frames = 0;
+		uint64_t busyFrames = 0;
+		uint64_t allocations = 0;
+		uint64_t referenceOperations = 0;
+	};
+
+	std::atomic<bool>                    foreground = false;
+	std::atomic<bool>                    running = true;
+	std::atomic<bool>                    idle = false;
+	std::atomic<bool>                    redrawRequested = true;
+	std::atomic<long long>               wakeRequestTime = 0;
+	IdleStatistics                       idleStatistics;
+	FrameCounters                        frameCounters;
+	long long                            reportedResizes = 0;
+	CoreDispatcher                       dispatcher = nullptr;
+	concurrency::event                   simulationWake;
+	std::unique_ptr<Renderer>            renderer;
+	std::unique_ptr<Audio>               audio;
+	std::unique_ptr<Game>                game;
+	Game::Input                          keyboardInput;
+	std::unique_ptr<Replay::Session>     replaySession;
+	Audio::Sound                         beepSound;
+	std::unique_ptr<Recorder>            recorder;
+	std::unique_ptr<StateExport::Writer> stateExport;
+	std::unique_ptr<MatchHistory::File>  matchHistory;
+	critical_section                     gameLock;
+	TaskGraph                            startup{ [](std::function<void()> work) { create_task(std::move(work)); } };
+	bool                                 startupReported = false;
+	critical_section                     gamepadLock;
+	std::vector<Gamepad>                 gamepads;
+	std::thread                          simulationThread;
+	TripleBuffer<Scene>                  scenes;
 };
 
 int __stdcall wWinMain(HINSTANCE, HINSTANCE, PWSTR, int) {
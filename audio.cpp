@@ -49,7 +49,6 @@ auto Audio::createSound(const std::wstring& filename) const -> Sound {
 	BYTE* audioData = nullptr;
 	DWORD audioDataSize = 0;
 	Sound sound = {};
-	sound.ptr = nullptr;
 	while (true) {
 		com_ptr<IMFSample> sample;
 		com_ptr<IMFMediaBuffer> buffer;
@@ -71,7 +70,48 @@ auto Audio::createSound(const std::wstring& filename) const -> Sound {
 		check_hresult(buffer->Unlock());
 	}
 
-	// Create a new sound with a desired sound format.
-	check_hresult(engine->CreateSourceVoice(&sound.ptr, waveFormat));
+	// Preallocate enough silence to delay the sound by the longest simulation step.
+	constexpr auto MaxDelayMS = 250;
+	sound.sampleRate = waveFormat->nSamplesPerSec;
+	sound.blockAlign = waveFormat->nBlockAlign;
+	sound.silence.resize(sound.sampleRate * MaxDelayMS / 1000 * sound.blockAlign, waveFormat->wBitsPerSample == 8 ? 0x80 : 0);
+
+	// Create the voices of the sound with a desired sound format.
+	for (auto& voice : sound.voices) {
+		check_hresult(engine->CreateSourceVoice(&voice, waveFormat));
+	}
 	return sound;
+}
+
+void Audio::Sound::play(float delayMS) {
+	// Find out how far the mixer has got with the buffers of each voice.
+	VoicePool::Samples playedSamples = {};
+	for (auto i = 0u; i < voices.size(); i++) {
+		XAUDIO2_VOICE_STATE state = {};
+		voices[i]->GetState(&state);
+		playedSamples[i] = state.SamplesPlayed;
+	}
+
+	// Pad only the gap between the end of the queued buffers and the onset so the sound starts exactly the given
+	// amount of time after the submission.
+	const auto maxDelaySamples = static_cast<UINT32>(silence.size() / blockAlign);
+	const auto delaySamples = std::min(static_cast<UINT32>(delayMS * sampleRate / 1000.f), maxDelaySamples);
+	const auto playback = pool.schedule(playedSamples, delaySamples, static_cast<UINT32>(bytes.size() / blockAlign));
+	if (playback.lateness > 0) {
+		lateOnsets++;
+	}
+
+	auto voice = voices[playback.voice];
+	if (playback.silence > 0) {
+		XAUDIO2_BUFFER silenceBuffer = {};
+		silenceBuffer.AudioBytes = playback.silence * blockAlign;
+		silenceBuffer.pAudioData = &silence[0];
+		check_hresult(voice->SubmitSourceBuffer(&silenceBuffer));
+	}
+
+	XAUDIO2_BUFFER waveBuffer = {};
+	waveBuffer.AudioBytes = static_cast<UINT32>(bytes.size());
+	waveBuffer.pAudioData = &bytes[0];
+	check_hresult(voice->SubmitSourceBuffer(&waveBuffer));
+	voice->Start();
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "voicepool.hpp"
+
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <mfapi.h>
 #include <mfidl.h>
@@ -10,16 +14,16 @@
 class Audio final {
 public:
 	struct Sound {
-		IXAudio2SourceVoice* ptr = nullptr;
-		std::vector<BYTE>    bytes;
+		std::array<IXAudio2SourceVoice*, VoicePool::VoiceCount> voices = {};
+		VoicePool                                              pool;
+		std::vector<BYTE>                                      bytes;
+		std::vector<BYTE>                                      silence;
+		UINT32                                                 sampleRate = 0;
+		UINT32                                                 blockAlign = 0;
+		long long                                              lateOnsets = 0;
 
-		void play() {
-			XAUDIO2_BUFFER waveBuffer = {};
-			waveBuffer.AudioBytes = static_cast<UINT32>(bytes.size());
-			waveBuffer.pAudioData = &bytes[0];
-			winrt::check_hresult(ptr->SubmitSourceBuffer(&waveBuffer));
-			ptr->Start();
-		}
+		auto isLoaded() const -> bool { return voices[0] != nullptr; }
+		void play(float delayMS = 0.f);
 	};
 
 	Audio();
@@ -0,0 +1,57 @@
+#include "game.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std::chrono;
+
+// Stresses the collision resolution of the simulation with ever faster balls. The ball bounces between the walls,
+// so it never hits a paddle that would slow it down to the maximum velocity of play, and the cost of a step must
+// stay bounded by the collision budget. The step count can be given as an argument.
+namespace {
+	constexpr auto DefaultSteps = 200000;
+
+	void measure(float speed, int steps) {
+		auto state = MatchState{};
+		state.kind = MatchState::Kind::PLAY;
+		state.ballPosition = { .5f, .5f };
+		state.ballVelocity = { 0.f, speed };
+		state.leftPaddlePosition = { .05f, .5f };
+		state.rightPaddlePosition = { .95f, .5f };
+		auto game = Game{ 1, false };
+		game.setMatchState(state);
+
+		auto collisions = 0ull;
+		auto budgetSteps = 0;
+		auto stepTimes = std::vector<steady_clock::duration>(steps);
+		const auto startTime = steady_clock::now();
+		for (auto step = 0; step < steps; step++) {
+			const auto stepStart = steady_clock::now();
+			game.update(milliseconds(step % 3 == 2 ? 9 : 8));
+			stepTimes[step] = steady_clock::now() - stepStart;
+			collisions += game.getSoundEvents().size();
+			budgetSteps += game.getSoundEvents().size() == Game::MaxCollisionsPerStep;
+		}
+		const auto time = duration<double, std::nano>(steady_clock::now() - startTime).count();
+
+		// The slowest steps are those of the operating system preempting the benchmark, so report a high percentile.
+		const auto percentile = stepTimes.begin() + steps * 999 / 1000;
+		std::nth_element(stepTimes.begin(), percentile, stepTimes.end());
+		std::printf("%10g %12.1f %12.1f %12.2f %10.1f%% %12.1f\n", speed, time / steps,
+			duration<double, std::nano>(*percentile).count(), double(collisions) / steps, 100.0 * budgetSteps / steps,
+			game.getCarriedMS());
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const auto steps = argc > 1 ? std::atoi(argv[1]) : DefaultSteps;
+	std::printf("%d steps of about 8.3 ms, at most %d collisions per step\n", steps, Game::MaxCollisionsPerStep);
+	std::printf("%10s %12s %12s %12s %11s %12s\n", "speed", "ns/step", "p99.9 ns", "collisions", "budget", "carried ms");
+	for (const auto speed : { .0004f, .004f, .04f, .4f, 4.f, 40.f }) {
+		measure(speed, steps);
+	}
+	return EXIT_SUCCESS;
+}
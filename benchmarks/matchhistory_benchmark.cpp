@@ -0,0 +1,76 @@
+#include "matchhistory.hpp"
+#include "matchstate.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace MatchHistory;
+using namespace std::chrono;
+
+// Appends rows of random matches into a match history and measures the speed of aggregate queries over them. The row
+// count can be given as an argument, e.g. 10000000 for a quicker run.
+namespace {
+	constexpr auto DefaultRows = 100000000ull;
+
+	// Players get better over the history, so the rallies get longer and the ball faster.
+	auto makeRow(std::mt19937& random, uint64_t index, uint64_t rows) -> Row {
+		const auto progress = static_cast<float>(index) / rows;
+		auto row = Row{};
+		const auto player1Wins = random() % 2 == 0;
+		const auto loserScore = static_cast<float>(random() % MatchState::WinningScore);
+		row[PLAYER1_SCORE] = player1Wins ? float(MatchState::WinningScore) : loserScore;
+		row[PLAYER2_SCORE] = player1Wins ? loserScore : float(MatchState::WinningScore);
+		row[RALLIES] = row[PLAYER1_SCORE] + row[PLAYER2_SCORE];
+		row[LONGEST_RALLY] = static_cast<float>(1 + random() % (2 + static_cast<int>(progress * 30)));
+		row[PEAK_BALL_SPEED] = .001f + progress * .002f + std::uniform_real_distribution<float>{ 0.f, .0005f }(random);
+		row[DURATION] = static_cast<float>(30000 + random() % 60000) + progress * 120000.f;
+		return row;
+	}
+
+	void measure(const File& file, const char* name, const std::vector<Range>& filters, Column column) {
+		const auto startTime = steady_clock::now();
+		const auto aggregate = file.query(filters, column);
+		const auto time = duration<double>(steady_clock::now() - startTime).count();
+		const auto scannedRows = static_cast<double>(std::min<uint64_t>(aggregate.scannedBlocks * BlockRows, file.getRowCount()));
+		std::printf("%-28s %12llu rows %8.3f s %8.1f M rows/s scanned, %llu scanned blocks, %llu skipped blocks\n", name,
+			static_cast<unsigned long long>(aggregate.rows), time, scannedRows / time / 1e6,
+			static_cast<unsigned long long>(aggregate.scannedBlocks), static_cast<unsigned long long>(aggregate.skippedBlocks));
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const auto rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DefaultRows;
+	const auto filename = std::filesystem::temp_directory_path() / "matchhistory_benchmark.bin";
+	std::filesystem::remove(filename);
+
+	{
+		auto random = std::mt19937{ 1 };
+		auto file = File{ filename, File::Mode::APPEND };
+		if (!file.isOpen()) {
+			std::fprintf(stderr, "cannot create %s\n", filename.string().c_str());
+			return EXIT_FAILURE;
+		}
+		const auto startTime = steady_clock::now();
+		for (auto i = 0ull; i < rows; i++) {
+			file.append(makeRow(random, i, rows));
+		}
+		const auto time = duration<double>(steady_clock::now() - startTime).count();
+		std::printf("append %llu rows: %.3f s, %.1f M rows/s, %.1f MB\n", static_cast<unsigned long long>(rows), time,
+			rows / time / 1e6, std::filesystem::file_size(filename) / 1e6);
+	}
+
+	const auto file = File{ filename, File::Mode::READ };
+	const auto fastMatches = Range{ PEAK_BALL_SPEED, .0028f, INFINITY };
+	const auto player1Wins = Range{ PLAYER1_SCORE, float(MatchState::WinningScore), INFINITY };
+	measure(file, "mean duration", {}, DURATION);
+	measure(file, "player 1 wins", { player1Wins }, PLAYER1_SCORE);
+	measure(file, "fast matches", { fastMatches }, PEAK_BALL_SPEED);
+	measure(file, "player 1 wins, fast matches", { fastMatches, player1Wins }, PLAYER1_SCORE);
+	measure(file, "long rallies", { { LONGEST_RALLY, 25.f, INFINITY } }, DURATION);
+	std::filesystem::remove(filename);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include "fixed.hpp"
+#include "game.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std::chrono;
+
+// Compares the float and fixed-point Scalar. The kernels measure both types on batches of values, while the simulation
+// plays with the Scalar of the build, so run both scalar_benchmark and scalar_benchmark_fixed. The step count can be
+// given as an argument.
+namespace {
+	constexpr auto DefaultSteps = 5000000;
+	constexpr auto Values = 4096;
+	constexpr auto Rounds = 20000;
+
+	// Moves the values by their velocities like the simulation moves the entities.
+	template <typename T>
+	auto integrate(std::vector<T>& positions, const std::vector<T>& velocities) -> double {
+		const auto deltaMS = T(8);
+		const auto startTime = steady_clock::now();
+		for (auto round = 0; round < Rounds; round++) {
+			for (auto i = 0; i < Values; i++) {
+				positions[i] += velocities[i] * deltaMS;
+			}
+		}
+		return duration<double>(steady_clock::now() - startTime).count();
+	}
+
+	// Computes the times of entry like the swept collision test does.
+	template <typename T>
+	auto sweep(const std::vector<T>& positions, const std::vector<T>& velocities, std::vector<T>& times) -> double {
+		const auto edge = T(1);
+		const auto startTime = steady_clock::now();
+		for (auto round = 0; round < Rounds / 10; round++) {
+			for (auto i = 0; i < Values; i++) {
+				times[i] = (edge - positions[i]) / velocities[i];
+			}
+		}
+		return duration<double>(steady_clock::now() - startTime).count();
+	}
+
+	template <typename T>
+	void measureKernels(const char* name) {
+		auto positions = std::vector<T>(Values);
+		auto velocities = std::vector<T>(Values);
+		auto times = std::vector<T>(Values);
+		for (auto i = 0; i < Values; i++) {
+			positions[i] = T(static_cast<float>(i % 100) / 100.f);
+			velocities[i] = T(.0004f + static_cast<float>(i % 37) * .0001f);
+		}
+		const auto integrateTime = integrate(positions, velocities);
+		const auto sweepTime = sweep(positions, velocities, times);
+		auto checksum = 0.f;
+		for (auto i = 0; i < Values; i++) {
+			checksum += static_cast<float>(positions[i]) + static_cast<float>(times[i]);
+		}
+		std::printf("%-6s %14.1f %14.1f %14g\n", name, double(Values) * Rounds / integrateTime / 1e6,
+			double(Values) * (Rounds / 10) / sweepTime / 1e6, checksum);
+	}
+
+	// Plays with a paddle that follows the ball and another one that moves back and forth.
+	auto simulate(int steps) -> uint64_t {
+		auto game = Game{ 1, false };
+		for (auto step = 0; step < steps; step++) {
+			const auto state = game.getMatchState();
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG;
+			input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y - .1f ? -1 : state.ballPosition.y > state.leftPaddlePosition.y + .1f ? 1 : 0;
+			input.player2Movement = static_cast<int8_t>(step / 80 % 3 - 1);
+			game.onInput(input);
+			game.update(milliseconds(step % 3 == 2 ? 9 : 8));
+		}
+		return game.getStateHash();
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const auto steps = argc > 1 ? std::atoi(argv[1]) : DefaultSteps;
+
+	std::printf("%-6s %14s %14s %14s\n", "scalar", "integrate M/s", "sweep M/s", "checksum");
+	measureKernels<float>("float");
+	measureKernels<Fixed>("fixed");
+
+	#if defined(PONG_FIXED_POINT)
+	const auto scalar = "fixed";
+	#else
+	const auto scalar = "float";
+	#endif
+	const auto startTime = steady_clock::now();
+	const auto hash = simulate(steps);
+	const auto time = duration<double>(steady_clock::now() - startTime).count();
+	std::printf("simulate %d steps with %s: %.3f s, %.2f M steps/s, state hash %016llx\n", steps, scalar, time,
+		steps / time / 1e6, static_cast<unsigned long long>(hash));
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include "spectator.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace Spectator;
+using namespace std::chrono;
+
+namespace {
+	constexpr auto TickRate = 120;
+	constexpr auto Ticks = TickRate * 5;
+	constexpr auto RoundTripTicks = 6;
+	constexpr auto PacketLoss = .02;
+
+	// Simulates a rally where the ball bounces between the walls and the paddles follow it with a delay.
+	class Match final {
+	public:
+		auto step() -> MatchState {
+			constexpr auto StepMS = 1000.f / TickRate;
+			state.kind = MatchState::Kind::PLAY;
+			state.ballPosition += state.ballVelocity * StepMS;
+			if (state.ballPosition.y < 0.f || state.ballPosition.y > 1.f) {
+				state.ballVelocity.y = -state.ballVelocity.y;
+			}
+			if (state.ballPosition.x < .05f || state.ballPosition.x > .95f) {
+				state.ballVelocity.x = -state.ballVelocity.x;
+				state.ballPosition.x < .5f ? state.player2Score++ : state.player1Score++;
+				state.player1Score %= 10;
+				state.player2Score %= 10;
+			}
+			follow(state.leftPaddlePosition, state.leftPaddleVelocity, state.ballVelocity.x < 0.f);
+			follow(state.rightPaddlePosition, state.rightPaddleVelocity, state.ballVelocity.x > 0.f);
+			return state;
+		}
+	private:
+		void follow(Vec2f& position, Vec2f& velocity, bool active) {
+			constexpr auto PaddleSpeed = .0015f;
+			const auto distance = state.ballPosition.y - position.y;
+			velocity.y = !active || std::fabs(distance) < .05f ? 0.f : distance > 0.f ? PaddleSpeed : -PaddleSpeed;
+			position.y += velocity.y * (1000.f / TickRate);
+		}
+
+		MatchState state = { MatchState::Kind::PLAY, 0, 0, { .5f, .5f }, { .0011f, .0007f }, { .05f, .5f }, {}, { .95f, .5f }, {} };
+	};
+
+	void run(int spectators) {
+		struct Spectator {
+			Encoder                              encoder;
+			Decoder                              decoder;
+			MemoryTransport                      transport;
+			std::array<uint32_t, RoundTripTicks> acknowledgements = {};
+		};
+		auto viewers = std::vector<Spectator>(spectators);
+		auto match = Match{};
+		auto random = std::mt19937{ 1 };
+		auto loss = std::bernoulli_distribution{ PacketLoss };
+		auto packet = std::vector<uint8_t>{};
+		auto encodeTime = nanoseconds::zero();
+		auto decodeTime = nanoseconds::zero();
+		auto decoded = uint64_t(0);
+		auto rejected = uint64_t(0);
+		for (auto tick = 0; tick < Ticks; tick++) {
+			const auto state = quantize(match.step());
+
+			// Encode the state for each spectator against the baseline it has acknowledged a round trip ago.
+			const auto encodeStart = steady_clock::now();
+			for (auto& viewer : viewers) {
+				viewer.encoder.acknowledge(viewer.acknowledgements[tick % RoundTripTicks]);
+				viewer.encoder.encode(state, packet);
+				viewer.transport.send(packet);
+			}
+			encodeTime += steady_clock::now() - encodeStart;
+
+			// Lose some of the packets on their way to the spectators.
+			const auto decodeStart = steady_clock::now();
+			for (auto& viewer : viewers) {
+				while (viewer.transport.receive(packet)) {
+					if (loss(random)) {
+						continue;
+					}
+					viewer.decoder.decode(packet) ? decoded++ : rejected++;
+				}
+				viewer.acknowledgements[tick % RoundTripTicks] = viewer.decoder.getSequence();
+			}
+			decodeTime += steady_clock::now() - decodeStart;
+		}
+
+		auto bytes = uint64_t(0);
+		auto fullSnapshots = uint64_t(0);
+		for (const auto& viewer : viewers) {
+			bytes += viewer.transport.getSentBytes();
+			fullSnapshots += viewer.encoder.getFullSnapshots();
+		}
+		const auto seconds = static_cast<double>(Ticks) / TickRate;
+		const auto packets = static_cast<double>(spectators) * Ticks;
+		std::printf("%11d %14.0f %12.3f %12.2f %12.2f %9.2f%% %9llu\n",
+			spectators,
+			bytes / seconds / spectators,
+			bytes / seconds / 1e6,
+			packets / duration<double>(encodeTime).count() / 1e6,
+			decoded / duration<double>(decodeTime).count() / 1e6,
+			100.0 * fullSnapshots / packets,
+			static_cast<unsigned long long>(rejected));
+	}
+}
+
+// Streams a simulated match at 120 Hz to an increasing number of spectators over lossy in-memory transports and
+// reports the bandwidth of the stream along with the encoding and decoding throughput.
+int main() {
+	std::printf("%d ticks at %d Hz, %.0f%% packet loss, %d tick round trip\n", Ticks, TickRate, PacketLoss * 100, RoundTripTicks);
+	std::printf("%11s %14s %12s %12s %12s %10s %9s\n", "spectators", "B/s/spectator", "total MB/s", "encode Mp/s", "decode Mp/s", "full", "rejected");
+	for (auto spectators : { 1, 10, 100, 1000, 10000 }) {
+		run(spectators);
+	}
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include "game.hpp"
+#include "telemetry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using namespace Telemetry;
+using namespace std::chrono;
+
+// Measures the cost of recording telemetry events: on their own in bursts that fit the ring, with a full ring where
+// they are dropped, and as the overhead they add to the simulation steps of the game. The step count can be given as
+// an argument.
+namespace {
+	constexpr auto DefaultSteps = 2000000;
+	constexpr auto Bursts = 100;
+	constexpr auto BurstEvents = 2048;
+
+	// Waits until the flusher has moved every recorded event into the log.
+	void waitFlushed() {
+		while (getStatistics().flushed < getStatistics().recorded) {
+			std::this_thread::sleep_for(milliseconds(1));
+		}
+	}
+
+	void measureRecord() {
+		auto time = steady_clock::duration{};
+		for (auto burst = 0; burst < Bursts; burst++) {
+			const auto startTime = steady_clock::now();
+			for (auto i = 0; i < BurstEvents; i++) {
+				record(EventType::PADDLE_HIT, 1, i & 1, .05f, .5f, .001f);
+			}
+			time += steady_clock::now() - startTime;
+			waitFlushed();
+		}
+		const auto events = double(Bursts) * BurstEvents;
+		std::printf("record %.0f events: %.1f ns/event, %llu dropped\n", events,
+			duration<double, std::nano>(time).count() / events, static_cast<unsigned long long>(getStatistics().dropped));
+	}
+
+	void measureDropped() {
+		constexpr auto Events = 10000000;
+		const auto droppedBefore = getStatistics().dropped;
+		const auto startTime = steady_clock::now();
+		for (auto i = 0; i < Events; i++) {
+			record(EventType::WALL_BOUNCE, 1, i & 1, .5f, 0.f, .001f);
+		}
+		const auto time = steady_clock::now() - startTime;
+		std::printf("record %d events into a full ring: %.1f ns/event, %llu dropped\n", Events,
+			duration<double, std::nano>(time).count() / Events,
+			static_cast<unsigned long long>(getStatistics().dropped - droppedBefore));
+		waitFlushed();
+	}
+
+	// Plays with a paddle that follows the ball and another one that moves back and forth.
+	auto measureSteps(int steps, bool telemetry) -> double {
+		auto game = Game{ 1, telemetry };
+		const auto startTime = steady_clock::now();
+		for (auto step = 0; step < steps; step++) {
+			const auto state = game.getMatchState();
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG;
+			input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y - .1f ? -1 : state.ballPosition.y > state.leftPaddlePosition.y + .1f ? 1 : 0;
+			input.player2Movement = static_cast<int8_t>(step / 80 % 3 - 1);
+			game.onInput(input);
+			game.update(milliseconds(step % 3 == 2 ? 9 : 8));
+		}
+		return duration<double, std::nano>(steady_clock::now() - startTime).count();
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const auto steps = argc > 1 ? std::atoi(argv[1]) : DefaultSteps;
+	const auto filename = std::filesystem::temp_directory_path() / "telemetry_benchmark.bin";
+	std::filesystem::remove(filename);
+
+	start(filename);
+	registerThread();
+	measureRecord();
+	measureDropped();
+
+	// The game records a few events per second of play, so the overhead per step is far below that of an event.
+	const auto recordedBefore = getStatistics().recorded;
+	const auto withTelemetry = measureSteps(steps, true);
+	const auto events = getStatistics().recorded - recordedBefore;
+	const auto withoutTelemetry = measureSteps(steps, false);
+	std::printf("simulate %d steps: %.1f ns/step with telemetry, %.1f ns/step without, %llu events, %.1f ns/event\n",
+		steps, withTelemetry / steps, withoutTelemetry / steps, static_cast<unsigned long long>(events),
+		events > 0 ? (withTelemetry - withoutTelemetry) / events : 0.0);
+	stop();
+
+	const auto startTime = steady_clock::now();
+	auto summary = Summary{};
+	aggregate(filename, summary);
+	const auto time = duration<double>(steady_clock::now() - startTime).count();
+	std::printf("aggregate %llu events of %llu matches: %.3f s, %.1f M events/s\n",
+		static_cast<unsigned long long>(summary.events), static_cast<unsigned long long>(summary.matches), time,
+		summary.events / time / 1e6);
+	std::filesystem::remove(filename);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "diagnostics.hpp"
+#include "game.hpp"
+#include "tiledrenderer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std::chrono;
+
+// Measures the frame rate of drawing walls of playing matches into a 1920x1080 software framebuffer. The matches are
+// stepped between the frames outside of the measured time. The frame count can be given as an argument.
+namespace {
+	constexpr auto DefaultFrames = 600;
+	constexpr auto Width = 1920;
+	constexpr auto Height = 1080;
+
+	void measure(int matches, int frames) {
+		const auto columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(matches * double(Width) / Height / 1.3))));
+		const auto rows = (matches + columns - 1) / columns;
+		auto renderer = TiledRenderer{ Width, Height, columns, rows };
+		auto games = std::vector<Game>{};
+		games.reserve(matches);
+		for (auto i = 0; i < matches; i++) {
+			games.emplace_back(i, false);
+		}
+		auto scenes = std::vector<Scene>(matches);
+
+		// Play with paddles that follow the ball at two steps of the simulation per frame.
+		auto time = steady_clock::duration{};
+		auto allocations = uint64_t(0);
+		for (auto frame = 0; frame < frames; frame++) {
+			for (auto i = 0; i < matches; i++) {
+				for (auto step = 0; step < 2; step++) {
+					const auto state = games[i].getMatchState();
+					auto input = Game::Input{};
+					input.start = state.kind == MatchState::Kind::DIALOG;
+					input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y ? -1 : 1;
+					input.player2Movement = static_cast<int8_t>((frame + i) / 40 % 3 - 1);
+					games[i].onInput(input);
+					games[i].update(milliseconds(step == 0 ? 8 : 9));
+				}
+				scenes[i].clear();
+				games[i].render(scenes[i]);
+			}
+			const auto before = Diagnostics::getCounters();
+			const auto startTime = steady_clock::now();
+			renderer.draw(scenes);
+			time += steady_clock::now() - startTime;
+			allocations += Diagnostics::getCounters().allocations - before.allocations;
+		}
+		const auto frameTime = duration<double, std::milli>(time).count() / frames;
+		std::printf("%8d %5dx%-5d %12.3f %10.1f %12.1f %12llu\n", matches, columns, rows, frameTime, 1000.0 / frameTime,
+			frameTime * 1e6 / matches, static_cast<unsigned long long>(allocations));
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const auto frames = argc > 1 ? std::atoi(argv[1]) : DefaultFrames;
+	std::printf("%d frames of %dx%d pixels, the allocations include the glyph atlases of the first frames\n", frames,
+		Width, Height);
+	std::printf("%8s %11s %12s %10s %12s %12s\n", "matches", "tiles", "ms/frame", "frames/s", "ns/match", "allocations");
+	for (const auto matches : { 1, 16, 64, 256, 1024 }) {
+		measure(matches, frames);
+	}
+	return EXIT_SUCCESS;
+}
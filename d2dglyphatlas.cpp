@@ -0,0 +1,89 @@
+#include "pch.hpp"
+#include "d2dglyphatlas.hpp"
+
+using namespace winrt;
+
+D2DGlyphAtlas::D2DGlyphAtlas(ID2D1DeviceContext* ctx, IDWriteFactory* factory, float size, std::wstring_view text) : atlas(size, text) {
+	constexpr auto MaxAtlasWidth = 2048.f;
+	constexpr auto MaxAtlasPixels = 4096u;
+
+	// Construct the text format that is used to rasterize the glyphs. It also draws the text when there's no atlas.
+	check_hresult(factory->CreateTextFormat(
+		L"Calibri",
+		nullptr,
+		DWRITE_FONT_WEIGHT_REGULAR,
+		DWRITE_FONT_STYLE_NORMAL,
+		DWRITE_FONT_STRETCH_NORMAL,
+		size,
+		L"en-us",
+		format.put()
+	));
+	check_hresult(format->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER));
+	check_hresult(format->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP));
+
+	// Build a layout for each glyph and measure its advance and the height of the line.
+	std::array<com_ptr<IDWriteTextLayout>, GlyphAtlas::LastGlyph - GlyphAtlas::FirstGlyph + 1> layouts;
+	std::array<float, GlyphAtlas::LastGlyph - GlyphAtlas::FirstGlyph + 1> advances = {};
+	auto lineHeight = 0.f;
+	for (auto character : atlas.getCharacters()) {
+		auto& layout = layouts[character - GlyphAtlas::FirstGlyph];
+		check_hresult(factory->CreateTextLayout(&character, 1, format.get(), MaxAtlasWidth, size * 2.f, layout.put()));
+		check_hresult(layout->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING));
+		DWRITE_TEXT_METRICS metrics{};
+		check_hresult(layout->GetMetrics(&metrics));
+		advances[character - GlyphAtlas::FirstGlyph] = metrics.widthIncludingTrailingWhitespace;
+		lineHeight = std::max(lineHeight, metrics.height);
+	}
+
+	// Pack the glyphs into rows of the atlas and keep drawing with DirectWrite when they don't fit a single bitmap.
+	auto dpiX = 0.f;
+	auto dpiY = 0.f;
+	ctx->GetDpi(&dpiX, &dpiY);
+	const auto maxPixels = static_cast<float>(std::min(ctx->GetMaximumBitmapSize(), MaxAtlasPixels));
+	const auto advance = [&advances](wchar_t character) { return advances[character - GlyphAtlas::FirstGlyph]; };
+	if (!atlas.pack(advance, lineHeight, std::min(MaxAtlasWidth, maxPixels * 96.f / dpiX), maxPixels * 96.f / dpiY)) {
+		return;
+	}
+
+	// Construct an offscreen target with an alpha channel so the atlas can be used as an opacity mask.
+	com_ptr<ID2D1BitmapRenderTarget> target;
+	const auto atlasSize = D2D1::SizeF(atlas.getWidth(), atlas.getHeight());
+	const auto pixelFormat = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
+	check_hresult(ctx->CreateCompatibleRenderTarget(
+		&atlasSize,
+		nullptr,
+		&pixelFormat,
+		D2D1_COMPATIBLE_RENDER_TARGET_OPTIONS_NONE,
+		target.put()
+	));
+	com_ptr<ID2D1SolidColorBrush> brush;
+	check_hresult(target->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), brush.put()));
+
+	// Rasterize the glyphs into their cells.
+	target->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
+	target->BeginDraw();
+	target->Clear(D2D1::ColorF(D2D1::ColorF::Black, 0.f));
+	for (auto character : atlas.getCharacters()) {
+		const auto glyph = atlas.findGlyph(character);
+		target->DrawTextLayout({ glyph->left, glyph->top }, layouts[character - GlyphAtlas::FirstGlyph].get(), brush.get());
+	}
+	check_hresult(target->EndDraw());
+	check_hresult(target->GetBitmap(bitmap.put()));
+}
+
+void D2DGlyphAtlas::drawCentered(ID2D1DeviceContext* ctx, ID2D1Brush* brush, std::wstring_view text, D2D1_POINT_2F position) const {
+	// Let DirectWrite center the text into a wide box when the glyphs weren't rasterized.
+	if (!bitmap) {
+		const auto fontSize = atlas.getFontSize();
+		const auto box = D2D1::RectF(position.x - fontSize * 64.f, position.y, position.x + fontSize * 64.f, position.y + fontSize * 2.f);
+		ctx->DrawText(text.data(), static_cast<UINT32>(text.size()), format.get(), box, brush);
+		return;
+	}
+
+	const auto lineHeight = atlas.getLineHeight();
+	atlas.layoutCentered(text, position.x, [&](const GlyphAtlas::Glyph& glyph, float x) {
+		const auto source = D2D1::RectF(glyph.left, glyph.top, glyph.left + glyph.advance, glyph.top + lineHeight);
+		const auto destination = D2D1::RectF(x, position.y, x + glyph.advance, position.y + lineHeight);
+		ctx->FillOpacityMask(bitmap.get(), brush, &destination, &source);
+	});
+}
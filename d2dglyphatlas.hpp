@@ -0,0 +1,29 @@
+#pragma once
+
+#include <d2d1_3.h>
+#include <dwrite_3.h>
+#include <string>
+#include <string_view>
+#include <winrt/base.h>
+
+#include "glyphatlas.hpp"
+
+// D2DGlyphAtlas is the Direct2D backend of GlyphAtlas for a single font size.
+//
+// Text is drawn by filling the glyph cells of the atlas through an opacity mask, which avoids the text shaping and
+// rasterization DirectWrite would otherwise perform for each frame. When the glyphs don't fit the maximum bitmap size,
+// text is drawn with DirectWrite instead.
+class D2DGlyphAtlas final {
+public:
+	D2DGlyphAtlas(ID2D1DeviceContext* ctx, IDWriteFactory* factory, float fontSize, std::wstring_view characters);
+
+	auto getFontSize() const -> float { return atlas.getFontSize(); }
+	auto getCharacters() const -> const std::wstring& { return atlas.getCharacters(); }
+	auto contains(std::wstring_view text) const -> bool { return atlas.contains(text); }
+
+	void drawCentered(ID2D1DeviceContext* ctx, ID2D1Brush* brush, std::wstring_view text, D2D1_POINT_2F position) const;
+private:
+	GlyphAtlas                        atlas;
+	winrt::com_ptr<ID2D1Bitmap>       bitmap;
+	winrt::com_ptr<IDWriteTextFormat> format;
+};
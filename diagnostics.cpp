@@ -0,0 +1,35 @@
+#include "diagnostics.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static thread_local Diagnostics::Counters counters;
+
+auto Diagnostics::getCounters() -> Counters {
+	return counters;
+}
+
+void Diagnostics::countReferenceOperation() {
+	counters.referenceOperations++;
+}
+
+// Replace the global allocation functions to count every heap allocation made through new and delete.
+void* operator new(size_t size) {
+	counters.allocations++;
+	counters.allocatedBytes += size;
+	if (auto ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+	if (ptr) {
+		counters.deallocations++;
+		std::free(ptr);
+	}
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	operator delete(ptr);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+// Diagnostics counts the heap allocations and the reference count operations made by the calling thread.
+//
+// The counters are thread-local so a thread can compare them before and after a piece of work to find out whether
+// the work allocated without being disturbed by other threads. Allocations are counted for every use of new and
+// delete. Reference count operations are counted for the smart pointers wrapped into Counted, i.e. the AddRef and
+// Release calls and the shared_ptr count changes that our own code makes.
+namespace Diagnostics {
+	struct Counters {
+		uint64_t allocations = 0;
+		uint64_t deallocations = 0;
+		uint64_t allocatedBytes = 0;
+		uint64_t referenceOperations = 0;
+	};
+
+	auto getCounters() -> Counters;
+	void countReferenceOperation();
+
+	// Counted is a reference counted smart pointer such as std::shared_ptr or winrt::com_ptr that counts the
+	// reference count operations of its copies. Moves don't touch the reference count so they aren't counted.
+	template <typename Pointer>
+	class Counted final : public Pointer {
+	public:
+		using Pointer::Pointer;
+		Counted() = default;
+		Counted(const Pointer& pointer) : Pointer(pointer) { count(); }
+		Counted(Pointer&& pointer) noexcept : Pointer(std::move(pointer)) {}
+		Counted(const Counted& other) : Pointer(other) { count(); }
+		Counted(Counted&& other) noexcept : Pointer(std::move(other)) {}
+		~Counted() { count(); }
+
+		auto operator=(const Counted& other) -> Counted& {
+			if (this != &other) {
+				count();
+				Pointer::operator=(other);
+				count();
+			}
+			return *this;
+		}
+
+		auto operator=(Counted&& other) noexcept -> Counted& {
+			if (this != &other) {
+				count();
+				Pointer::operator=(std::move(other));
+			}
+			return *this;
+		}
+	private:
+		void count() const {
+			if (static_cast<bool>(*this)) {
+				countReferenceOperation();
+			}
+		}
+	};
+}
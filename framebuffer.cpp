@@ -0,0 +1,65 @@
+#include "framebuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Framebuffer::Framebuffer(int w, int h) : width(w), height(h), clip{ 0, 0, w, h }, pixels(static_cast<size_t>(w) * h, Black) {
+}
+
+void Framebuffer::clear(uint32_t color) {
+	std::fill(pixels.begin(), pixels.end(), color);
+}
+
+void Framebuffer::setClip(float left, float top, float right, float bottom) {
+	resetClip();
+	clip = toClip(left, top, right, bottom);
+}
+
+void Framebuffer::resetClip() {
+	clip = { 0, 0, width, height };
+}
+
+void Framebuffer::fill(uint32_t color, float left, float top, float right, float bottom) {
+	const auto area = toClip(left, top, right, bottom);
+	for (auto y = area.top; y < area.bottom; y++) {
+		std::fill(pixels.begin() + y * width + area.left, pixels.begin() + y * width + area.right, color);
+	}
+}
+
+void Framebuffer::fillMask(uint32_t color, const uint8_t* mask, int pitch, int maskWidth, int maskHeight, int x, int y) {
+	// Clip the mask into the clip rectangle.
+	const auto x0 = std::max(0, clip.left - x);
+	const auto y0 = std::max(0, clip.top - y);
+	const auto x1 = std::min(maskWidth, clip.right - x);
+	const auto y1 = std::min(maskHeight, clip.bottom - y);
+	for (auto row = y0; row < y1; row++) {
+		const auto coverage = mask + row * pitch;
+		const auto target = pixels.data() + (y + row) * width;
+		for (auto column = x0; column < x1; column++) {
+			const auto alpha = uint32_t(coverage[column]);
+			auto& pixel = target[x + column];
+			if (alpha == 255) {
+				pixel = color;
+			} else if (alpha > 0) {
+				// Blend each channel with the coverage of the pixel.
+				auto blended = uint32_t(0);
+				for (auto shift = 0; shift < 32; shift += 8) {
+					const auto source = (color >> shift) & 0xff;
+					const auto destination = (pixel >> shift) & 0xff;
+					blended |= ((source * alpha + destination * (255 - alpha) + 127) / 255) << shift;
+				}
+				pixel = blended;
+			}
+		}
+	}
+}
+
+auto Framebuffer::toClip(float left, float top, float right, float bottom) const -> Clip {
+	// A pixel is covered when its center is, so adjacent rectangles never cover the same pixel twice.
+	auto result = Clip{};
+	result.left = std::clamp(static_cast<int>(std::ceil(left - .5f)), clip.left, clip.right);
+	result.top = std::clamp(static_cast<int>(std::ceil(top - .5f)), clip.top, clip.bottom);
+	result.right = std::clamp(static_cast<int>(std::ceil(right - .5f)), result.left, clip.right);
+	result.bottom = std::clamp(static_cast<int>(std::ceil(bottom - .5f)), result.top, clip.bottom);
+	return result;
+}
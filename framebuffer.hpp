@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Framebuffer is a BGRA bitmap in memory that the CPU draws into, e.g. to render without a GPU on Linux or within the
+// benchmarks. Colors are 0xAARRGGBB values, which are laid out in memory like the frames that the Recorder encodes.
+class Framebuffer final {
+public:
+	static constexpr auto Black = uint32_t(0xff000000);
+	static constexpr auto White = uint32_t(0xffffffff);
+
+	Framebuffer(int width, int height);
+
+	auto getWidth() const -> int { return width; }
+	auto getHeight() const -> int { return height; }
+	auto getPixels() const -> const uint32_t* { return pixels.data(); }
+	auto getPixel(int x, int y) const -> uint32_t { return pixels[y * width + x]; }
+
+	void clear(uint32_t color);
+
+	// Limits the following fills to the pixels whose centers are within the rectangle until the clip is reset.
+	void setClip(float left, float top, float right, float bottom);
+	void resetClip();
+
+	// Fills the pixels whose centers are within the rectangle.
+	void fill(uint32_t color, float left, float top, float right, float bottom);
+
+	// Blends the color into the pixels through a mask of 8-bit coverage values, whose top-left corner is drawn at x, y.
+	void fillMask(uint32_t color, const uint8_t* mask, int pitch, int maskWidth, int maskHeight, int x, int y);
+private:
+	// Clip is the range of the pixels that may be filled, from the first column and row to past the last ones.
+	struct Clip {
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	auto toClip(float left, float top, float right, float bottom) const -> Clip;
+
+	int                   width;
+	int                   height;
+	Clip                  clip;
+	std::vector<uint32_t> pixels;
+};
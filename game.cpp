@@ -1,14 +1,23 @@
-#include "pch.hpp"
 #include "game.hpp"
+#include "matchhistory.hpp"
 
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
-using namespace winrt::Windows::Gaming::Input;
-using namespace winrt::Windows::UI::Core;
-using namespace winrt::Windows::System;
+// Score texts are static views so that changing the score never allocates.
+constexpr std::wstring_view ScoreTexts[] = { L"0", L"1", L"2", L"3", L"4", L"5", L"6", L"7", L"8", L"9", L"10" };
 
-Game::Game(const Audio& audio) {
-	state = std::make_shared<Game::DialogState>(*this, L"Press X key or button to start a game");
+constexpr auto WinningScore = MatchState::WinningScore;
+constexpr auto StartDescription = L"Press X key or button to start a game";
+constexpr auto LeftWinsDescription = L"Left player wins! Press X for rematch.";
+constexpr auto RightWinsDescription = L"Right player wins! Press X for rematch.";
+
+Game::Game(unsigned int seed, bool telemetryEnabled)
+	: dialogState(*this), countdownState(*this), playState(*this), telemetry(telemetryEnabled), rng(seed) {
+	// The start screen precedes every match, so entering it isn't logged as a state change of a match.
+	dialogState.enter(StartDescription);
+	state = &dialogState;
 
 	ball.extent = { .0115f, .015f };
 	ball.position = { .5f, .5f };
@@ -27,11 +36,11 @@ Game::Game(const Audio& audio) {
 	rightPaddle.position = { .95f, .5f };
 	rightPaddle.velocity = { 0.f, 0.f };
 
-	leftScore.text = std::to_wstring(player1Score);
+	leftScore.text = ScoreTexts[player1Score];
 	leftScore.position = { .35f, .025f };
 	leftScore.fontSize = .27f;
 
-	rightScore.text = std::to_wstring(player2Score);
+	rightScore.text = ScoreTexts[player2Score];
 	rightScore.position = { .65f, .025f };
 	rightScore.fontSize = .27f;
 
@@ -41,10 +50,104 @@ Game::Game(const Audio& audio) {
 	rightGoal.extent = leftGoal.extent;
 	rightGoal.position = { 1.5f + ball.extent.x * 4.f, .5f };
 
-	beepSound = audio.createSound(L"Assets/beep.wav");
+	soundEvents.reserve(MaxCollisionsPerStep);
+}
+
+auto Game::getMatchState() const -> MatchState {
+	auto matchState = MatchState{};
+	matchState.kind = (state == &dialogState ? MatchState::Kind::DIALOG : state == &countdownState ? MatchState::Kind::COUNTDOWN : MatchState::Kind::PLAY);
+	matchState.player1Score = player1Score;
+	matchState.player2Score = player2Score;
+	matchState.ballPosition = ball.position;
+	matchState.ballVelocity = ball.velocity;
+	matchState.leftPaddlePosition = leftPaddle.position;
+	matchState.leftPaddleVelocity = leftPaddle.velocity;
+	matchState.rightPaddlePosition = rightPaddle.position;
+	matchState.rightPaddleVelocity = rightPaddle.velocity;
+	return matchState;
+}
+
+auto Game::getStateHash() const -> uint64_t {
+	// Hash the exact bits of the match state with FNV-1a so that any difference in the simulation shows up.
+	constexpr auto Offset = 14695981039346656037ull;
+	constexpr auto Prime = 1099511628211ull;
+	auto hash = Offset;
+	const auto mix = [&hash](uint64_t value) {
+		for (auto i = 0; i < 8; i++) {
+			hash = (hash ^ ((value >> (i * 8)) & 0xff)) * Prime;
+		}
+	};
+	const auto mixScalar = [&mix](Scalar value) {
+		#if defined(PONG_FIXED_POINT)
+		mix(static_cast<uint64_t>(value.getRaw()));
+		#else
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		mix(bits);
+		#endif
+	};
+	const auto matchState = getMatchState();
+	mix(static_cast<uint64_t>(matchState.kind));
+	mix(static_cast<uint64_t>(matchState.player1Score));
+	mix(static_cast<uint64_t>(matchState.player2Score));
+	for (const auto& vector : { matchState.ballPosition, matchState.ballVelocity, matchState.leftPaddlePosition,
+		matchState.leftPaddleVelocity, matchState.rightPaddlePosition, matchState.rightPaddleVelocity }) {
+		mixScalar(vector.x);
+		mixScalar(vector.y);
+	}
+	return hash;
+}
+
+void Game::setMatchState(const MatchState& matchState) {
+	// Switch the state directly as entering a state would also reset the entities.
+	countdownState.stop();
+	switch (matchState.kind) {
+	case MatchState::Kind::DIALOG:
+		if (matchState.player1Score >= WinningScore) {
+			dialogState.enter(LeftWinsDescription);
+		} else if (matchState.player2Score >= WinningScore) {
+			dialogState.enter(RightWinsDescription);
+		} else {
+			dialogState.enter(StartDescription);
+		}
+		state = &dialogState;
+		break;
+	case MatchState::Kind::COUNTDOWN:
+		countdownState.resume();
+		state = &countdownState;
+		break;
+	case MatchState::Kind::PLAY:
+		state = &playState;
+		break;
+	}
+	setScores(matchState.player1Score, matchState.player2Score);
+	ball.position = matchState.ballPosition;
+	ball.velocity = matchState.ballVelocity;
+	leftPaddle.position = matchState.leftPaddlePosition;
+	leftPaddle.velocity = matchState.leftPaddleVelocity;
+	rightPaddle.position = matchState.rightPaddlePosition;
+	rightPaddle.velocity = matchState.rightPaddleVelocity;
+}
+
+void Game::update(std::chrono::milliseconds delta) {
+	soundEvents.clear();
+
+	// Split the step at the timer expiries, so that a state entered by a timer only simulates the time after it.
+	auto elapsed = std::chrono::milliseconds(0);
+	do {
+		const auto step = timers.getTimeToNextExpiry(delta - elapsed);
+		stepTime = Scalar(static_cast<int>(elapsed.count()));
+		state->update(step);
+		timers.advance(step);
+		elapsed += step;
+	} while (elapsed < delta);
+}
+
+void Game::playSound(Sound sound) {
+	soundEvents.push_back({ sound, static_cast<float>(stepTime) });
 }
 
-auto Game::detectCollision(float deltaMS) const -> Collision {
+auto Game::detectCollision(Scalar deltaMS) const -> Collision {
 	auto result = Collision{};
 	detectCollision(deltaMS, ball, leftPaddle, result);
 	detectCollision(deltaMS, ball, rightPaddle, result);
@@ -59,7 +162,7 @@ auto Game::detectCollision(float deltaMS) const -> Collision {
 	return result;
 }
 
-void Game::detectCollision(float deltaMS, const Rectangle& r1, const Rectangle& r2, Collision& result) const {
+void Game::detectCollision(Scalar deltaMS, const Rectangle& r1, const Rectangle& r2, Collision& result) const {
 	auto hit = detectCollision(deltaMS, r1, r2);
 	if (hit.lhs && hit.time < result.time) {
 		result.time = hit.time;
@@ -68,7 +171,7 @@ void Game::detectCollision(float deltaMS, const Rectangle& r1, const Rectangle&
 	}
 }
 
-auto Game::detectCollision(float deltaMS, const Rectangle& a, const Rectangle& b) const->Collision {
+auto Game::detectCollision(Scalar deltaMS, const Rectangle& a, const Rectangle& b) const->Collision {
 	auto collision = Collision{};
 
 	const auto amin = a.position - a.extent;
@@ -87,9 +190,13 @@ auto Game::detectCollision(float deltaMS, const Rectangle& a, const Rectangle& b
 	// We will use relative velocity where 'a' is treated as stationary.
 	const auto v = (b.velocity - a.velocity) * deltaMS;
 
+	// Boxes that don't move relative to each other along an axis never meet if they are apart on it.
+	if (v.x == 0.f && (amax.x < bmin.x || bmax.x < amin.x)) return collision;
+	if (v.y == 0.f && (amax.y < bmin.y || bmax.y < amin.y)) return collision;
+
 	// Initialize times for the first and last contact.
-	auto tmin = -FLT_MAX;
-	auto tmax = FLT_MAX;
+	auto tmin = std::numeric_limits<Scalar>::lowest();
+	auto tmax = std::numeric_limits<Scalar>::max();
 
 	// Find the first and last contact from x-axis.
 	if (v.x < .0f) {
@@ -126,45 +233,60 @@ auto Game::detectCollision(float deltaMS, const Rectangle& a, const Rectangle& b
 }
 
 auto Game::resolveCollision(const Collision& collision) -> bool {
-	constexpr auto BallVelocityMultiplier = 1.1f;
-	constexpr auto Nudge = .001f;
+	constexpr auto BallVelocityMultiplier = Scalar(1.1f);
+	constexpr auto MaxBallVelocity = Scalar(.004f);
+	constexpr auto Nudge = Scalar(.001f);
 	if (collision.lhs == &ball) {
 		if (collision.rhs == &bottomWall) {
 			ball.position.y = bottomWall.position.y - bottomWall.extent.y - ball.extent.y - Nudge;
 			ball.velocity.y = -ball.velocity.y;
-			beepSound.play();
+			playSound(Sound::BEEP);
+			logEvent(Telemetry::EventType::WALL_BOUNCE, 1, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 		} else if (collision.rhs == &topWall) {
 			ball.position.y = topWall.position.y + topWall.extent.y + ball.extent.y + Nudge;
 			ball.velocity.y = -ball.velocity.y;
-			beepSound.play();
+			playSound(Sound::BEEP);
+			logEvent(Telemetry::EventType::WALL_BOUNCE, 0, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 		} else if (collision.rhs == &leftGoal) {
+			logEvent(Telemetry::EventType::GOAL, 0, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 			player2Score++;
-			if (player2Score >= 10) {
-				state = std::make_shared<DialogState>(*this, L"Right player wins! Press X for rematch.");
+			recordGoal(player2Score >= WinningScore);
+			if (player2Score >= WinningScore) {
+				showDialog(RightWinsDescription);
 			} else {
-				rightScore.text = std::to_wstring(player2Score);
-				state = std::make_shared<CountdownState>(*this);
+				rightScore.text = ScoreTexts[player2Score];
+				startCountdown();
 			}
 			return true;
 		} else if (collision.rhs == &rightGoal) {
+			logEvent(Telemetry::EventType::GOAL, 1, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 			player1Score++;
-			if (player1Score >= 10) {
-				state = std::make_shared<DialogState>(*this, L"Left player wins! Press X for rematch.");
+			recordGoal(player1Score >= WinningScore);
+			if (player1Score >= WinningScore) {
+				showDialog(LeftWinsDescription);
 			} else {
-				leftScore.text = std::to_wstring(player1Score);
-				state = std::make_shared<CountdownState>(*this);
+				leftScore.text = ScoreTexts[player1Score];
+				startCountdown();
 			}
 			return true;
 		} else if (collision.rhs == &leftPaddle) {
 			ball.position.x = leftPaddle.position.x + leftPaddle.extent.x + ball.extent.x + Nudge;
 			ball.velocity.x = -ball.velocity.x;
 			ball.velocity = ball.velocity * BallVelocityMultiplier;
-			beepSound.play();
+			ball.velocity.x = std::clamp(ball.velocity.x, -MaxBallVelocity, MaxBallVelocity);
+			ball.velocity.y = std::clamp(ball.velocity.y, -MaxBallVelocity, MaxBallVelocity);
+			playSound(Sound::BEEP);
+			recordPaddleHit();
+			logEvent(Telemetry::EventType::PADDLE_HIT, 0, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 		} else if (collision.rhs == &rightPaddle) {
 			ball.position.x = rightPaddle.position.x - rightPaddle.extent.x - ball.extent.x - Nudge;
 			ball.velocity.x = -ball.velocity.x;
 			ball.velocity = ball.velocity * BallVelocityMultiplier;
-			beepSound.play();
+			ball.velocity.x = std::clamp(ball.velocity.x, -MaxBallVelocity, MaxBallVelocity);
+			ball.velocity.y = std::clamp(ball.velocity.y, -MaxBallVelocity, MaxBallVelocity);
+			playSound(Sound::BEEP);
+			recordPaddleHit();
+			logEvent(Telemetry::EventType::PADDLE_HIT, 1, static_cast<float>(ball.position.x), static_cast<float>(ball.position.y), getBallSpeed());
 		}
 	} else if (collision.lhs == &leftPaddle) {
 		if (collision.rhs == &bottomWall) {
@@ -184,7 +306,70 @@ auto Game::resolveCollision(const Collision& collision) -> bool {
 	return false;
 }
 
-Game::DialogState::DialogState(Game& game, const std::wstring& descriptionText) : State(game) {
+auto Game::getBallSpeed() const -> float {
+	return std::hypot(static_cast<float>(ball.velocity.x), static_cast<float>(ball.velocity.y));
+}
+
+void Game::logEvent(Telemetry::EventType type, uint8_t subject, float x, float y, float speed) const {
+	#if !defined(PONG_NO_TELEMETRY)
+	if (telemetry) {
+		Telemetry::record(type, match, subject, x, y, speed);
+	}
+	#endif
+}
+
+void Game::startMatchRecord() {
+	matchRecord = MatchRecord{};
+	matchRecord.startTime = timers.getTime();
+}
+
+void Game::recordPaddleHit() {
+	matchRecord.rallyHits++;
+	matchRecord.longestRally = std::max(matchRecord.longestRally, matchRecord.rallyHits);
+	matchRecord.peakBallSpeed = std::max(matchRecord.peakBallSpeed, getBallSpeed());
+}
+
+void Game::recordGoal(bool matchOver) {
+	matchRecord.rallies++;
+	matchRecord.rallyHits = 0;
+	if (matchOver && matchHistory) {
+		auto row = MatchHistory::Row{};
+		row[MatchHistory::PLAYER1_SCORE] = static_cast<float>(player1Score);
+		row[MatchHistory::PLAYER2_SCORE] = static_cast<float>(player2Score);
+		row[MatchHistory::RALLIES] = static_cast<float>(matchRecord.rallies);
+		row[MatchHistory::LONGEST_RALLY] = static_cast<float>(matchRecord.longestRally);
+		row[MatchHistory::PEAK_BALL_SPEED] = matchRecord.peakBallSpeed;
+		row[MatchHistory::DURATION] = static_cast<float>(timers.getTime() - matchRecord.startTime);
+		matchHistory->append(row);
+	}
+}
+
+void Game::showDialog(std::wstring_view description) {
+	dialogState.enter(description);
+	state = &dialogState;
+	logEvent(Telemetry::EventType::STATE_CHANGE, static_cast<uint8_t>(MatchState::Kind::DIALOG), 0.f, 0.f, 0.f);
+}
+
+void Game::setScores(int player1, int player2) {
+	player1Score = player1;
+	player2Score = player2;
+	leftScore.text = ScoreTexts[std::min(player1Score, WinningScore)];
+	rightScore.text = ScoreTexts[std::min(player2Score, WinningScore)];
+}
+
+void Game::startCountdown() {
+	countdownState.enter();
+	state = &countdownState;
+	logEvent(Telemetry::EventType::STATE_CHANGE, static_cast<uint8_t>(MatchState::Kind::COUNTDOWN), 0.f, 0.f, 0.f);
+}
+
+void Game::startPlay() {
+	playState.enter();
+	state = &playState;
+	logEvent(Telemetry::EventType::STATE_CHANGE, static_cast<uint8_t>(MatchState::Kind::PLAY), 0.f, 0.f, 0.f);
+}
+
+Game::DialogState::DialogState(Game& game) : State(game) {
 	background.extent = { 0.375f, 0.40f };
 	background.position = { .5f, .5f };
 
@@ -195,66 +380,68 @@ Game::DialogState::DialogState(Game& game, const std::wstring& descriptionText)
 	topic.position = { .5f, .3f };
 	topic.fontSize = .1f;
 
-	description.text = descriptionText;
 	description.position = { .5f, .6f };
 	description.fontSize = .05f;
 }
 
-void Game::DialogState::render(const Renderer& renderer) {
-	renderer.draw(renderer.getWhiteBrush(), background);
-	renderer.draw(renderer.getBlackBrush(), foreground);
-	renderer.draw(renderer.getWhiteBrush(), topic);
-	renderer.draw(renderer.getWhiteBrush(), description);
+void Game::DialogState::enter(std::wstring_view descriptionText) {
+	description.text = descriptionText;
 }
 
-void Game::DialogState::onKeyDown(const KeyEventArgs& args) {
-	if (args.VirtualKey() == VirtualKey::X) {
-		startGame();
-	}
+void Game::DialogState::render(Scene& scene) {
+	scene.add(Scene::Brush::WHITE, background);
+	scene.add(Scene::Brush::BLACK, foreground);
+	scene.add(Scene::Brush::WHITE, topic);
+	scene.add(Scene::Brush::WHITE, description);
 }
 
-void Game::DialogState::onReadGamepad(int, const GamepadReading& reading) {
-	if (GamepadButtons::X == (reading.Buttons & GamepadButtons::X)) {
+void Game::DialogState::onInput(const Input& input) {
+	if (input.start) {
 		startGame();
 	}
 }
 
 void Game::DialogState::startGame() {
-	game.player1Score = 0;
-	game.player2Score = 0;
-	game.rightScore.text = std::to_wstring(game.player2Score);
-	game.leftScore.text = std::to_wstring(game.player1Score);
-	game.state = std::make_shared<CountdownState>(game);
+	game.match++;
+	game.startMatchRecord();
+	game.setScores(0, 0);
+	game.startCountdown();
 }
 
-Game::CountdownState::CountdownState(Game& game) : State(game) {
+void Game::CountdownState::enter() {
 	game.ball.position = { .5f, .5f };
 	game.ball.velocity = newRandomDirection();
 	game.leftPaddle.position.y = .5f;
 	game.rightPaddle.position.y = .5f;
+	resume();
 }
 
-void Game::CountdownState::update(std::chrono::milliseconds) {
-	if (--countdown <= 0) {
-		game.state = std::make_shared<PlayState>(game);
-	}
+void Game::CountdownState::resume() {
+	game.timers.schedule(timer, CountdownDuration, &CountdownState::onCountdownEnd, this);
 }
 
-void Game::CountdownState::render(const Renderer& renderer) {
-	renderer.draw(renderer.getWhiteBrush(), game.leftScore);
-	renderer.draw(renderer.getWhiteBrush(), game.rightScore);
-	renderer.draw(renderer.getWhiteBrush(), game.ball);
-	renderer.draw(renderer.getWhiteBrush(), game.topWall);
-	renderer.draw(renderer.getWhiteBrush(), game.bottomWall);
-	renderer.draw(renderer.getWhiteBrush(), game.leftPaddle);
-	renderer.draw(renderer.getWhiteBrush(), game.rightPaddle);
+void Game::CountdownState::stop() {
+	game.timers.cancel(timer);
+}
+
+void Game::CountdownState::onCountdownEnd(void* context) {
+	static_cast<CountdownState*>(context)->game.startPlay();
+}
+
+void Game::CountdownState::render(Scene& scene) {
+	scene.add(Scene::Brush::WHITE, game.leftScore);
+	scene.add(Scene::Brush::WHITE, game.rightScore);
+	scene.add(Scene::Brush::WHITE, game.ball);
+	scene.add(Scene::Brush::WHITE, game.topWall);
+	scene.add(Scene::Brush::WHITE, game.bottomWall);
+	scene.add(Scene::Brush::WHITE, game.leftPaddle);
+	scene.add(Scene::Brush::WHITE, game.rightPaddle);
 }
 
 auto Game::CountdownState::newRandomDirection() -> Vec2f {
-	constexpr auto BallInitialVelocity = .0004f;
-	static std::default_random_engine rng;
-	static std::uniform_int_distribution<std::mt19937::result_type> dist(0, 3);
-	switch (dist(rng)) {
+	constexpr auto BallInitialVelocity = Scalar(.0004f);
+	std::uniform_int_distribution<std::mt19937::result_type> dist(0, 3);
+	switch (dist(game.rng)) {
 	case 0: return Vec2f{ BallInitialVelocity, BallInitialVelocity };
 	case 1: return Vec2f{ BallInitialVelocity, -BallInitialVelocity };
 	case 2: return Vec2f{ -BallInitialVelocity, BallInitialVelocity };
@@ -262,16 +449,31 @@ auto Game::CountdownState::newRandomDirection() -> Vec2f {
 	return Vec2f{ -BallInitialVelocity, -BallInitialVelocity };
 }
 
+void Game::PlayState::enter() {
+	player1Movement = MoveDirection::NONE;
+	player2Movement = MoveDirection::NONE;
+	carriedMS = 0.f;
+}
+
 void Game::PlayState::update(std::chrono::milliseconds delta) {
 	// Apply the keyboard and gamepad input to paddle velocities.
-	constexpr auto PaddleVelocity = .001f;
-	game.leftPaddle.velocity.y = static_cast<float>(player1Movement) * PaddleVelocity;
-	game.rightPaddle.velocity.y = static_cast<float>(player2Movement) * PaddleVelocity;
+	constexpr auto PaddleVelocity = Scalar(.001f);
+	game.leftPaddle.velocity.y = Scalar(static_cast<int>(player1Movement)) * PaddleVelocity;
+	game.rightPaddle.velocity.y = Scalar(static_cast<int>(player2Movement)) * PaddleVelocity;
 
 	// Get the time (in milliseconds) we must consume during this simulation step.
-	auto deltaMS = static_cast<float>(delta.count());
+	auto deltaMS = Scalar(static_cast<int>(delta.count())) + carriedMS;
+	carriedMS = 0.f;
+
+	// Resolve at most a fixed amount of collisions to keep the cost of a step bounded at any ball velocity. Time that
+	// is left over is carried to the next step, so the movement is delayed instead of skipping the collision checks.
+	auto endRound = false;
+	for (auto iteration = 0; !endRound; iteration++) {
+		if (iteration == MaxCollisionsPerStep) {
+			carriedMS = std::min(deltaMS, Scalar(MaxCarriedMS));
+			break;
+		}
 
-	for (auto endRound = false; !endRound;) {
 		// Perform collision detection to find out the first collision.
 		const auto collision = game.detectCollision(deltaMS);
 		if (!collision.lhs && !collision.rhs) {
@@ -283,6 +485,7 @@ void Game::PlayState::update(std::chrono::milliseconds delta) {
 
 		// Consume simulation time.
 		deltaMS -= collision.time;
+		game.stepTime += collision.time;
 
 		// Apply movement to dynamic entities.
 		game.ball.position += game.ball.velocity * collision.time;
@@ -294,59 +497,17 @@ void Game::PlayState::update(std::chrono::milliseconds delta) {
 	}
 }
 
-void Game::PlayState::render(const Renderer& renderer) {
-	renderer.draw(renderer.getWhiteBrush(), game.leftScore);
-	renderer.draw(renderer.getWhiteBrush(), game.rightScore);
-	renderer.draw(renderer.getWhiteBrush(), game.ball);
-	renderer.draw(renderer.getWhiteBrush(), game.topWall);
-	renderer.draw(renderer.getWhiteBrush(), game.bottomWall);
-	renderer.draw(renderer.getWhiteBrush(), game.leftPaddle);
-	renderer.draw(renderer.getWhiteBrush(), game.rightPaddle);
+void Game::PlayState::render(Scene& scene) {
+	scene.add(Scene::Brush::WHITE, game.leftScore);
+	scene.add(Scene::Brush::WHITE, game.rightScore);
+	scene.add(Scene::Brush::WHITE, game.ball);
+	scene.add(Scene::Brush::WHITE, game.topWall);
+	scene.add(Scene::Brush::WHITE, game.bottomWall);
+	scene.add(Scene::Brush::WHITE, game.leftPaddle);
+	scene.add(Scene::Brush::WHITE, game.rightPaddle);
 }
 
-void Game::PlayState::onKeyDown(const KeyEventArgs& args) {
-	switch (args.VirtualKey()) {
-	case VirtualKey::Up:
-		player2Movement = MoveDirection::UP;
-		break;
-	case VirtualKey::Down:
-		player2Movement = MoveDirection::DOWN;
-		break;
-	case VirtualKey::W:
-		player1Movement = MoveDirection::UP;
-		break;
-	case VirtualKey::S:
-		player1Movement = MoveDirection::DOWN;
-		break;
-	}
-}
-
-void Game::PlayState::onKeyUp(const KeyEventArgs& args) {
-	switch (args.VirtualKey()) {
-	case VirtualKey::Up:
-		player2Movement = std::max(MoveDirection::NONE, player2Movement);
-		break;
-	case VirtualKey::Down:
-		player2Movement = std::min(MoveDirection::NONE, player2Movement);
-		break;
-	case VirtualKey::W:
-		player1Movement = std::max(MoveDirection::NONE, player1Movement);
-		break;
-	case VirtualKey::S:
-		player1Movement = std::min(MoveDirection::NONE, player1Movement);
-		break;
-	}
-}
-
-void Game::PlayState::onReadGamepad(int player, const GamepadReading& reading) {
-	constexpr auto DeadZone = .25f;
-	auto y = reading.LeftThumbstickY;
-	switch (player) {
-	case 0:
-		player1Movement = (y > DeadZone ? MoveDirection::UP : y < -DeadZone ? MoveDirection::DOWN : MoveDirection::NONE);
-		break;
-	case 1:
-		player2Movement = (y > DeadZone ? MoveDirection::UP : y < -DeadZone ? MoveDirection::DOWN : MoveDirection::NONE);
-		break;
-	}
+void Game::PlayState::onInput(const Input& input) {
+	player1Movement = static_cast<MoveDirection>(std::clamp<int>(input.player1Movement, -1, 1));
+	player2Movement = static_cast<MoveDirection>(std::clamp<int>(input.player2Movement, -1, 1));
 }
\ No newline at end of file
@@ -1,37 +1,75 @@
 #pragma once
 
-#include "audio.hpp"
-#include "renderer.hpp"
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "matchstate.hpp"
+#include "scene.hpp"
+#include "telemetry.hpp"
+#include "timerwheel.hpp"
+
+namespace MatchHistory { class File; }
 
 class Game {
 public:
-	Game(const Audio& audio);
-	void update(std::chrono::milliseconds delta) { state->update(delta); }
-	void render(const Renderer& renderer) { state->render(renderer); }
-	void onKeyDown(const winrt::Windows::UI::Core::KeyEventArgs& args) { state->onKeyDown(args); }
-	void onKeyUp(const winrt::Windows::UI::Core::KeyEventArgs& args) { state->onKeyUp(args); }
-	void onReadGamepad(int player, const winrt::Windows::Gaming::Input::GamepadReading& reading) { state->onReadGamepad(player, reading); }
+	// Input is the device independent input of a single simulation step. The host of the game turns the keyboard and
+	// gamepad state into an input for each step, so that recording the inputs is enough to replay a session.
+	struct Input {
+		int8_t player1Movement = 0; // -1 moves up, 1 moves down
+		int8_t player2Movement = 0;
+		bool   start = false;
+	};
+
+	// Sound is a sound effect that the host of the game plays.
+	enum class Sound { BEEP };
+
+	// SoundEvent is a sound that starts at an offset from the beginning of the step that caused it.
+	struct SoundEvent {
+		Sound sound;
+		float delayMS;
+	};
+
+	// A step resolves at most this many collisions to keep its cost bounded at any ball velocity. The time left over is
+	// carried to the next step, up to a limit.
+	static constexpr auto MaxCollisionsPerStep = 16;
+	static constexpr auto MaxCarriedMS = 250;
+
+	// Replayed games pass false as the telemetry flag so that they don't log their events again.
+	Game(unsigned int seed = std::default_random_engine::default_seed, bool telemetry = true);
+	void setMatchHistory(MatchHistory::File* history) { matchHistory = history; }
+	auto getMatchState() const -> MatchState;
+	void setMatchState(const MatchState& matchState);
+	void update(std::chrono::milliseconds delta);
+	void render(Scene& scene) { state->render(scene); }
+	auto isStatic() const -> bool { return state->isStatic(); }
+	auto getStateHash() const -> uint64_t;
+	auto getSoundEvents() const -> const std::vector<SoundEvent>& { return soundEvents; }
+	auto getCarriedMS() const -> float { return static_cast<float>(playState.getCarriedMS()); }
+	void onInput(const Input& input) { state->onInput(input); }
 private:
 	class State {
 	public:
 		State(Game& gameRef) : game(gameRef) {}
 		virtual void update(std::chrono::milliseconds delta) = 0;
-		virtual void render(const Renderer& renderer) = 0;
-		virtual void onKeyDown(const winrt::Windows::UI::Core::KeyEventArgs& args) = 0;
-		virtual void onKeyUp(const winrt::Windows::UI::Core::KeyEventArgs& args) = 0;
-		virtual void onReadGamepad(int player, const winrt::Windows::Gaming::Input::GamepadReading& reading) = 0;
+		virtual void render(Scene& scene) = 0;
+		virtual void onInput(const Input& input) = 0;
+		// A static state renders the same scene until an input changes the state.
+		virtual auto isStatic() const -> bool { return false; }
 	protected:
 		Game& game;
 	};
 
 	class DialogState final : public State {
 	public:
-		DialogState(Game& game, const std::wstring& description);
+		DialogState(Game& game);
+		void enter(std::wstring_view description);
 		void update(std::chrono::milliseconds) override {};
-		void render(const Renderer& renderer) override;
-		void onKeyDown(const winrt::Windows::UI::Core::KeyEventArgs& args) override;
-		void onKeyUp(const winrt::Windows::UI::Core::KeyEventArgs&) override {};
-		void onReadGamepad(int player, const winrt::Windows::Gaming::Input::GamepadReading& reading) override;
+		void render(Scene& scene) override;
+		void onInput(const Input& input) override;
+		auto isStatic() const -> bool override { return true; }
 		void startGame();
 	private:
 		Rectangle background;
@@ -42,47 +80,81 @@ private:
 
 	class CountdownState final : public State {
 	public:
-		CountdownState(Game& game);
-		void update(std::chrono::milliseconds delta) override;
-		void render(const Renderer& renderer) override;
-		void onKeyDown(const winrt::Windows::UI::Core::KeyEventArgs&) override {};
-		void onKeyUp(const winrt::Windows::UI::Core::KeyEventArgs&) override {};
-		void onReadGamepad(int, const winrt::Windows::Gaming::Input::GamepadReading&) override {};
+		CountdownState(Game& game) : State(game) {}
+		void enter();
+		void resume();
+		void stop();
+		void update(std::chrono::milliseconds) override {};
+		void render(Scene& scene) override;
+		void onInput(const Input&) override {};
 	private:
+		static constexpr auto CountdownDuration = std::chrono::milliseconds(833);
+		static void onCountdownEnd(void* context);
 		auto newRandomDirection()->Vec2f;
-		int countdown = 50;
+		TimerWheel::Timer timer;
 	};
 
 	class PlayState final : public State {
 	public:
 		enum class MoveDirection { UP = -1, NONE = 0, DOWN = 1};
 		PlayState(Game& game) : State(game) {}
+		void enter();
 		void update(std::chrono::milliseconds delta) override;
-		void render(const Renderer& renderer) override;
-		void onKeyDown(const winrt::Windows::UI::Core::KeyEventArgs& args) override;
-		void onKeyUp(const winrt::Windows::UI::Core::KeyEventArgs& args) override;
-		void onReadGamepad(int player, const winrt::Windows::Gaming::Input::GamepadReading& reading) override;
+		void render(Scene& scene) override;
+		void onInput(const Input& input) override;
+		auto getCarriedMS() const -> Scalar { return carriedMS; }
 	private:
 		MoveDirection player1Movement = MoveDirection::NONE;
 		MoveDirection player2Movement = MoveDirection::NONE;
+		Scalar        carriedMS = 0.f;
 	};
 
-	std::shared_ptr<State> state;
+	void showDialog(std::wstring_view description);
+	void setScores(int player1, int player2);
+	void startCountdown();
+	void startPlay();
 
-	int player1Score = 0;
-	int player2Score = 0;
+	// States are preallocated so that state transitions never allocate.
+	DialogState    dialogState;
+	CountdownState countdownState;
+	PlayState      playState;
+	State*         state;
+
+	int                        player1Score = 0;
+	int                        player2Score = 0;
+	uint32_t                   match = 0;
+	bool                       telemetry = true;
+	TimerWheel                 timers;
+	std::default_random_engine rng;
 
 	struct Collision {
 		const Rectangle* lhs;
 		const Rectangle* rhs;
-		float            time = FLT_MAX;
+		Scalar           time = std::numeric_limits<Scalar>::max();
 	};
 
-	auto detectCollision(float deltaMS) const->Collision;
-	void detectCollision(float deltaMS, const Rectangle& r1, const Rectangle& r2, Collision& result) const;
-	auto detectCollision(float deltaMS, const Rectangle& r1, const Rectangle& r2) const->Collision;
+	auto detectCollision(Scalar deltaMS) const->Collision;
+	void detectCollision(Scalar deltaMS, const Rectangle& r1, const Rectangle& r2, Collision& result) const;
+	auto detectCollision(Scalar deltaMS, const Rectangle& r1, const Rectangle& r2) const->Collision;
 
 	auto resolveCollision(const Collision& collision) -> bool;
+	auto getBallSpeed() const -> float;
+	void logEvent(Telemetry::EventType type, uint8_t subject, float x, float y, float speed) const;
+
+	// MatchRecord collects the statistics of the ongoing match for the match history.
+	struct MatchRecord {
+		int      rallies = 0;
+		int      rallyHits = 0;
+		int      longestRally = 0;
+		float    peakBallSpeed = 0.f;
+		uint64_t startTime = 0;
+	};
+
+	void startMatchRecord();
+	void recordPaddleHit();
+	void recordGoal(bool matchOver);
+
+	void playSound(Sound sound);
 
 	Rectangle ball;
 	Rectangle topWall;
@@ -94,5 +166,9 @@ private:
 	Text      leftScore;
 	Text      rightScore;
 
-	Audio::Sound beepSound;
+	MatchRecord         matchRecord;
+	MatchHistory::File* matchHistory = nullptr;
+
+	std::vector<SoundEvent> soundEvents;
+	Scalar                  stepTime = 0.f;
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "glyphatlas.hpp"
+
+#include <algorithm>
+
+GlyphAtlas::GlyphAtlas(float size, std::wstring_view text) : fontSize(size) {
+	// Collect the distinct printable characters, which are the only glyphs that are packed.
+	for (auto character : text) {
+		if (character >= FirstGlyph && character <= LastGlyph && characters.find(character) == std::wstring::npos) {
+			characters.push_back(character);
+		}
+	}
+}
+
+auto GlyphAtlas::contains(std::wstring_view text) const -> bool {
+	for (auto character : text) {
+		if (character >= FirstGlyph && character <= LastGlyph && characters.find(character) == std::wstring::npos) {
+			return false;
+		}
+	}
+	return true;
+}
+
+auto GlyphAtlas::pack(const std::function<float(wchar_t)>& advance, float glyphHeight, float maxWidth, float maxHeight) -> bool {
+	glyphs = {};
+	lineHeight = glyphHeight;
+	width = 0.f;
+	height = 0.f;
+	packed = false;
+
+	// Pack the glyphs into rows of the atlas.
+	auto x = 0.f;
+	auto y = 0.f;
+	for (auto character : characters) {
+		auto& glyph = glyphs[character - FirstGlyph];
+		glyph.advance = advance(character);
+		if (x > 0.f && x + glyph.advance > maxWidth) {
+			x = 0.f;
+			y += lineHeight + Padding;
+		}
+		glyph.left = x;
+		glyph.top = y;
+		width = std::max(width, x + glyph.advance);
+		x += glyph.advance + Padding;
+	}
+	height = y + lineHeight;
+
+	// Leave every glyph out when a glyph is wider than a row or the rows don't fit the atlas.
+	if (characters.empty() || width > maxWidth || height > maxHeight) {
+		glyphs = {};
+		return false;
+	}
+	for (auto character : characters) {
+		glyphs[character - FirstGlyph].packed = true;
+	}
+	packed = true;
+	return true;
+}
+
+auto GlyphAtlas::findGlyph(wchar_t character) const -> const Glyph* {
+	if (character < FirstGlyph || character > LastGlyph || !glyphs[character - FirstGlyph].packed) {
+		return nullptr;
+	}
+	return &glyphs[character - FirstGlyph];
+}
+
+auto GlyphAtlas::measure(std::wstring_view text) const -> float {
+	auto textWidth = 0.f;
+	for (auto character : text) {
+		if (auto glyph = findGlyph(character)) {
+			textWidth += glyph->advance;
+		}
+	}
+	return textWidth;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// GlyphAtlas packs the glyphs of printable ASCII characters for a single font size into the rows of an atlas bitmap.
+//
+// The atlas only does the bookkeeping of the glyph cells. A backend measures the glyphs, rasterizes them into the
+// cells of a bitmap of its own and draws text as blits of the cells that the atlas lays out, e.g. D2DGlyphAtlas with
+// DirectWrite and SoftwareGlyphAtlas into a Framebuffer. Only the glyphs of the given characters are packed. When they
+// don't fit the maximum size nothing is packed, and the backend has to draw the text in some other way.
+class GlyphAtlas final {
+public:
+	static constexpr auto FirstGlyph = L' ';
+	static constexpr auto LastGlyph = L'~';
+	static constexpr auto Padding = 2.f;
+
+	// Glyph is the cell of a character in the atlas. Cells are a line high and as wide as the advance of the glyph.
+	struct Glyph {
+		float left = 0.f;
+		float top = 0.f;
+		float advance = 0.f;
+		bool  packed = false;
+	};
+
+	GlyphAtlas(float fontSize, std::wstring_view characters);
+
+	auto getFontSize() const -> float { return fontSize; }
+	auto getCharacters() const -> const std::wstring& { return characters; }
+	auto getLineHeight() const -> float { return lineHeight; }
+	auto getWidth() const -> float { return width; }
+	auto getHeight() const -> float { return height; }
+	auto isPacked() const -> bool { return packed; }
+	auto contains(std::wstring_view text) const -> bool;
+
+	// Packs the glyphs with the given advances into rows no wider than the maximum width.
+	auto pack(const std::function<float(wchar_t)>& advance, float lineHeight, float maxWidth, float maxHeight) -> bool;
+
+	auto findGlyph(wchar_t character) const -> const Glyph*;
+	auto measure(std::wstring_view text) const -> float;
+
+	// Calls blit with each packed glyph of the text and its left edge, when the text is centered on the given x.
+	template <typename Blit>
+	void layoutCentered(std::wstring_view text, float x, Blit&& blit) const {
+		x -= measure(text) * .5f;
+		for (auto character : text) {
+			if (auto glyph = findGlyph(character)) {
+				blit(*glyph, x);
+				x += glyph->advance;
+			}
+		}
+	}
+private:
+	float                                         fontSize;
+	float                                         lineHeight = 0.f;
+	float                                         width = 0.f;
+	float                                         height = 0.f;
+	bool                                          packed = false;
+	std::wstring                                  characters;
+	std::array<Glyph, LastGlyph - FirstGlyph + 1> glyphs;
+};
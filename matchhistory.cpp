@@ -0,0 +1,191 @@
+#include "matchhistory.hpp"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace MatchHistory;
+
+File::File(const std::filesystem::path& filename, Mode fileMode) : mode(fileMode) {
+	// Readers share the file with the writer that keeps appending to it.
+	uint64_t size = 0;
+	#if defined(_WIN32)
+	const auto access = mode == Mode::APPEND ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+	const auto share = mode == Mode::APPEND ? FILE_SHARE_READ : FILE_SHARE_READ | FILE_SHARE_WRITE;
+	const auto disposition = mode == Mode::APPEND ? OPEN_ALWAYS : OPEN_EXISTING;
+	const auto handle = CreateFile2(filename.c_str(), access, share, disposition, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	file = handle;
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(handle, &fileSize)) {
+		return;
+	}
+	size = fileSize.QuadPart;
+	#else
+	descriptor = mode == Mode::APPEND ? open(filename.c_str(), O_RDWR | O_CREAT, 0644) : open(filename.c_str(), O_RDONLY);
+	struct stat status = {};
+	if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+		return;
+	}
+	size = status.st_size;
+	#endif
+
+	// A new file gets a header along with the first block.
+	if (size < sizeof(Header)) {
+		if (mode == Mode::READ || !map(1)) {
+			return;
+		}
+		header->magic = Magic;
+		header->version = Version;
+		header->rows.store(0, std::memory_order_release);
+		return;
+	}
+
+	const auto blockCount = (size - sizeof(Header)) / sizeof(Block);
+	if (!map(blockCount)) {
+		return;
+	}
+	if (header->magic != Magic || header->version != Version || header->rows.load(std::memory_order_acquire) > blockCount * BlockRows) {
+		unmap();
+	}
+}
+
+File::~File() {
+	unmap();
+	#if defined(_WIN32)
+	if (file) {
+		CloseHandle(file);
+	}
+	#else
+	if (descriptor >= 0) {
+		close(descriptor);
+	}
+	#endif
+}
+
+auto File::map(uint64_t blockCount) -> bool {
+	// Mapping a writable file beyond its end extends the file.
+	unmap();
+	const auto size = sizeof(Header) + blockCount * sizeof(Block);
+	#if defined(_WIN32)
+	const auto protection = mode == Mode::APPEND ? PAGE_READWRITE : PAGE_READONLY;
+	const auto access = mode == Mode::APPEND ? FILE_MAP_WRITE : FILE_MAP_READ;
+	mapping = CreateFileMappingFromApp(file, nullptr, protection, size, nullptr);
+	if (!mapping) {
+		return false;
+	}
+	header = static_cast<Header*>(MapViewOfFileFromApp(mapping, access, 0, size));
+	#else
+	if (mode == Mode::APPEND && ftruncate(descriptor, size) != 0) {
+		return false;
+	}
+	const auto protection = mode == Mode::APPEND ? PROT_READ | PROT_WRITE : PROT_READ;
+	const auto view = mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0);
+	header = view != MAP_FAILED ? static_cast<Header*>(view) : nullptr;
+	#endif
+	if (!header) {
+		unmap();
+		return false;
+	}
+	blocks = reinterpret_cast<Block*>(header + 1);
+	mappedBlocks = blockCount;
+	return true;
+}
+
+void File::unmap() {
+	#if defined(_WIN32)
+	if (header) {
+		UnmapViewOfFile(header);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	#else
+	if (header) {
+		munmap(header, sizeof(Header) + mappedBlocks * sizeof(Block));
+	}
+	#endif
+	header = nullptr;
+	blocks = nullptr;
+	mappedBlocks = 0;
+}
+
+auto File::getRowCount() const -> uint64_t {
+	// Rows appended after the file was opened for reading lie beyond the mapped blocks.
+	if (!header) {
+		return 0;
+	}
+	return std::min<uint64_t>(header->rows.load(std::memory_order_acquire), mappedBlocks * BlockRows);
+}
+
+void File::append(const Row& row) {
+	if (!header) {
+		return;
+	}
+
+	// Grow the file by doubling the amount of blocks to keep the amount of remappings low.
+	const auto rows = header->rows.load(std::memory_order_relaxed);
+	const auto blockIndex = rows / BlockRows;
+	const auto rowIndex = rows % BlockRows;
+	if (blockIndex >= mappedBlocks && !map(std::max<uint64_t>(1, mappedBlocks * 2))) {
+		return;
+	}
+
+	auto& block = blocks[blockIndex];
+	for (auto column = 0; column < COLUMN_COUNT; column++) {
+		const auto value = row[column];
+		block.values[column][rowIndex] = value;
+		block.minimum[column] = rowIndex == 0 ? value : std::min(block.minimum[column], value);
+		block.maximum[column] = rowIndex == 0 ? value : std::max(block.maximum[column], value);
+	}
+
+	// Publish the row only after its values have been written.
+	header->rows.store(rows + 1, std::memory_order_release);
+}
+
+auto File::query(const std::vector<Range>& filters, Column column) const -> Aggregate {
+	auto result = Aggregate{};
+	const auto rows = getRowCount();
+	for (auto blockIndex = 0ull; blockIndex * BlockRows < rows; blockIndex++) {
+		const auto& block = blocks[blockIndex];
+
+		// Skip the whole block whether any of the filters can't match any of its rows.
+		const auto skip = std::any_of(filters.begin(), filters.end(), [&block](const Range& range) {
+			return block.maximum[range.column] < range.minimum || block.minimum[range.column] > range.maximum;
+		});
+		if (skip) {
+			result.skippedBlocks++;
+			continue;
+		}
+		result.scannedBlocks++;
+
+		const auto count = std::min<uint64_t>(BlockRows, rows - blockIndex * BlockRows);
+		for (auto row = 0u; row < count; row++) {
+			const auto matches = std::all_of(filters.begin(), filters.end(), [&block, row](const Range& range) {
+				const auto value = block.values[range.column][row];
+				return value >= range.minimum && value <= range.maximum;
+			});
+			if (matches) {
+				const auto value = block.values[column][row];
+				result.minimum = result.rows == 0 ? value : std::min(result.minimum, value);
+				result.maximum = result.rows == 0 ? value : std::max(result.maximum, value);
+				result.sum += value;
+				result.rows++;
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// The match history is an append-only columnar file of finished matches that is accessed through a memory mapping.
+//
+// Rows are stored in blocks of a fixed amount of rows where each column is a contiguous array of values. Each block
+// starts with the minimum and maximum value of every column, so a query skips all blocks whose value ranges can't
+// match its filters without touching their rows. A single writer appends rows while any amount of readers query them.
+namespace MatchHistory {
+	constexpr auto Magic = 0x54534948u; // "HIST"
+	constexpr auto Version = 1u;
+	constexpr auto BlockRows = 4096u;
+
+	enum Column { PLAYER1_SCORE, PLAYER2_SCORE, RALLIES, LONGEST_RALLY, PEAK_BALL_SPEED, DURATION, COLUMN_COUNT };
+
+	// Row contains the values of a single match. Counts are stored as floats, which are exact up to 2^24.
+	using Row = std::array<float, COLUMN_COUNT>;
+
+	// Header is followed by the blocks. The row count is published only after the values of the rows are written.
+	struct Header {
+		uint32_t              magic;
+		uint32_t              version;
+		std::atomic<uint64_t> rows;
+	};
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "the row count must be lock-free in a shared file");
+
+	struct Block {
+		float minimum[COLUMN_COUNT];
+		float maximum[COLUMN_COUNT];
+		float values[COLUMN_COUNT][BlockRows];
+	};
+
+	// Range filters the rows whose column value is within the inclusive range.
+	struct Range {
+		Column column;
+		float  minimum;
+		float  maximum;
+	};
+
+	// Aggregate contains the aggregated values of a single column over the matching rows.
+	struct Aggregate {
+		uint64_t rows = 0;
+		double   sum = 0.0;
+		float    minimum = 0.f;
+		float    maximum = 0.f;
+		uint64_t scannedBlocks = 0;
+		uint64_t skippedBlocks = 0;
+	};
+
+	class File final {
+	public:
+		enum class Mode { READ, APPEND };
+
+		File(const std::filesystem::path& filename, Mode mode);
+		~File();
+		File(const File&) = delete;
+		auto operator=(const File&) -> File& = delete;
+
+		auto isOpen() const -> bool { return header != nullptr; }
+		auto getRowCount() const -> uint64_t;
+		void append(const Row& row);
+		auto query(const std::vector<Range>& filters, Column column) const -> Aggregate;
+	private:
+		auto map(uint64_t blockCount) -> bool;
+		void unmap();
+
+		Mode     mode;
+		#if defined(_WIN32)
+		void*    file = nullptr;
+		void*    mapping = nullptr;
+		#else
+		int      descriptor = -1;
+		#endif
+		Header*  header = nullptr;
+		Block*   blocks = nullptr;
+		uint64_t mappedBlocks = 0;
+	};
+}
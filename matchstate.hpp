@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#include "scene.hpp"
+
+// MatchState contains the dynamic parts of a match that are needed to reproduce its view.
+struct MatchState {
+	enum class Kind : uint8_t { DIALOG, COUNTDOWN, PLAY };
+
+	// The score that wins the match.
+	static constexpr auto WinningScore = 10;
+
+	Kind  kind = Kind::DIALOG;
+	int   player1Score = 0;
+	int   player2Score = 0;
+	Vec2f ballPosition = { 0.f, 0.f };
+	Vec2f ballVelocity = { 0.f, 0.f };
+	Vec2f leftPaddlePosition = { 0.f, 0.f };
+	Vec2f leftPaddleVelocity = { 0.f, 0.f };
+	Vec2f rightPaddlePosition = { 0.f, 0.f };
+	Vec2f rightPaddleVelocity = { 0.f, 0.f };
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "recorder.hpp"
+
+#include <cmath>
+#include <cstring>
+
+Recorder::Recorder(const std::filesystem::path& filename, int rate, int size) : frameRate(rate), poolSize(size) {
+	file.open(filename, std::ios::binary | std::ios::trunc);
+	encoder = std::thread(&Recorder::encode, this);
+}
+
+Recorder::~Recorder() {
+	if (encoder.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			running = false;
+		}
+		condition.notify_one();
+		encoder.join();
+	}
+}
+
+auto Recorder::getSlot(Clock::time_point timestamp) const -> long long {
+	const auto elapsed = std::chrono::duration<double>(timestamp - start).count();
+	return std::llround(elapsed * frameRate);
+}
+
+void Recorder::submit(const uint8_t* pixels, uint32_t pitch, uint32_t frameWidth, uint32_t frameHeight, Clock::time_point timestamp) {
+	// Y4M streams have a fixed resolution so frames of any other size can't be recorded.
+	auto index = -1;
+	auto slot = 0ll;
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (buffers.empty()) {
+			width = frameWidth;
+			height = frameHeight;
+			start = timestamp;
+			buffers.resize(poolSize, std::vector<uint8_t>(width * height * 4));
+			for (auto i = 0; i < poolSize; i++) {
+				freeBuffers.push_back(i);
+			}
+		}
+
+		// Drop frames that were captured faster than the stream rate.
+		slot = getSlot(timestamp);
+		if (slot > lastSlot && frameWidth == width && frameHeight == height && !freeBuffers.empty()) {
+			index = freeBuffers.back();
+			freeBuffers.pop_back();
+			lastSlot = slot;
+		}
+	}
+	if (index < 0) {
+		droppedFrames++;
+		return;
+	}
+
+	// Copy the frame outside of the lock as the source rows may be padded.
+	auto& buffer = buffers[index];
+	for (auto y = 0u; y < height; y++) {
+		memcpy(&buffer[y * width * 4], pixels + y * pitch, width * 4);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		queuedFrames.push_back({ index, slot });
+	}
+	condition.notify_one();
+}
+
+void Recorder::finish(Clock::time_point timestamp) {
+	// The last frame stays on screen until the recording is stopped.
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (!buffers.empty()) {
+			endSlot = getSlot(timestamp);
+		}
+		running = false;
+	}
+	condition.notify_one();
+	encoder.join();
+}
+
+void Recorder::encode() {
+	auto planes = std::vector<uint8_t>{};
+	auto nextSlot = 0ll;
+	const auto writeFrame = [&] {
+		file << "FRAME\n";
+		file.write(reinterpret_cast<const char*>(planes.data()), planes.size());
+		encodedFrames++;
+	};
+	while (true) {
+		// Wait for the next queued frame. Pending frames are still encoded when recording is stopped.
+		auto frame = Frame{};
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			condition.wait(lock, [this] { return !queuedFrames.empty() || !running; });
+			if (queuedFrames.empty()) {
+				break;
+			}
+			frame = queuedFrames.front();
+			queuedFrames.erase(queuedFrames.begin());
+		}
+
+		// Write the stream header along with the first frame as it defines the resolution.
+		const auto pixelCount = width * height;
+		if (planes.empty()) {
+			planes.resize(pixelCount * 3);
+			file << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRate << ":1 Ip A1:1 C444\n";
+		}
+
+		// Repeat the previous frame over the slots that have no capture of their own.
+		for (; nextSlot < frame.slot; nextSlot++) {
+			writeFrame();
+			duplicatedFrames++;
+		}
+
+		// Convert BGRA pixels into planar BT.601 YUV 4:4:4.
+		const auto& buffer = buffers[frame.buffer];
+		for (auto i = 0u; i < pixelCount; i++) {
+			const int b = buffer[i * 4 + 0];
+			const int g = buffer[i * 4 + 1];
+			const int r = buffer[i * 4 + 2];
+			planes[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			planes[pixelCount + i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			planes[pixelCount * 2 + i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+
+		// The buffer can be reused as soon as it has been converted.
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			freeBuffers.push_back(frame.buffer);
+		}
+
+		writeFrame();
+		nextSlot = frame.slot + 1;
+	}
+
+	// Hold the last frame until the recording was finished.
+	if (!planes.empty()) {
+		for (; nextSlot <= endSlot; nextSlot++) {
+			writeFrame();
+			duplicatedFrames++;
+		}
+	}
+	file.flush();
+}
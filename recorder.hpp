@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Recorder encodes captured BGRA frames into a Y4M video file on a background thread.
+//
+// Frames are copied into a fixed pool of buffers that is allocated with the first frame. Submitting never waits for
+// the encoder: when every buffer is still in use the frame is dropped and counted instead.
+//
+// Y4M streams have a constant frame rate while frames are captured once per present, so each frame is placed into
+// the stream slot of its capture time. Frames that arrive before their slot is due are dropped and the previous frame
+// is duplicated over slots without a capture, e.g. while the renderer idles on a static screen. Finishing encodes the
+// pending frames and holds the last one until the given time.
+class Recorder final {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	Recorder(const std::filesystem::path& filename, int frameRate, int poolSize = 8);
+	~Recorder();
+
+	void submit(const uint8_t* pixels, uint32_t pitch, uint32_t width, uint32_t height, Clock::time_point timestamp);
+	void drop() { droppedFrames++; }
+	void finish(Clock::time_point timestamp);
+
+	auto getEncodedFrames() const -> long long { return encodedFrames; }
+	auto getDroppedFrames() const -> long long { return droppedFrames; }
+	auto getDuplicatedFrames() const -> long long { return duplicatedFrames; }
+private:
+	struct Frame {
+		int       buffer;
+		long long slot;
+	};
+
+	auto getSlot(Clock::time_point timestamp) const -> long long;
+	void encode();
+
+	std::ofstream                     file;
+	int                               frameRate;
+	int                               poolSize;
+	uint32_t                          width = 0;
+	uint32_t                          height = 0;
+	Clock::time_point                 start;
+	long long                         lastSlot = -1;
+	long long                         endSlot = -1;
+	std::vector<std::vector<uint8_t>> buffers;
+	std::vector<int>                  freeBuffers;
+	std::vector<Frame>                queuedFrames;
+	std::mutex                        mutex;
+	std::condition_variable           condition;
+	bool                              running = true;
+	std::atomic<long long>            encodedFrames = 0;
+	std::atomic<long long>            droppedFrames = 0;
+	std::atomic<long long>            duplicatedFrames = 0;
+	std::thread                       encoder;
+};
@@ -46,6 +46,9 @@ Renderer::Renderer() {
 
 void Renderer::initDeviceResources() {
 	// clear all possible old definitions.
+	glyphAtlases.clear();
+	captureSlots = {};
+	frameLatencyWaitable.close();
 	swapChain = nullptr;
 	d2dDeviceCtx = nullptr;
 	d2dDevice = nullptr;
@@ -89,18 +92,15 @@ void Renderer::initWindowResources() {
 	d2dDeviceCtx->SetTarget(nullptr);
 	d3dDeviceCtx->Flush();
 
+	// Glyphs are rasterized for a specific window size and DPI.
+	glyphAtlases.clear();
+
+	// Frame captures must match the size of the back buffer.
+	captureSlots = {};
+
 	// TODO perhaps we could adjust this in some other way?
-	// calculate window entity offset to maintain aspect ratio.
-	windowOffset = { 0,0 };
-	auto aspect = windowSize.Width / windowSize.Height;
-	const auto desiredAspect = 1.3f;
-	if (abs(aspect - desiredAspect) > 0) {
-		if (aspect > desiredAspect) {
-			windowOffset.Width = (windowSize.Width - desiredAspect * windowSize.Height) / 2.f;
-		} else {
-			windowOffset.Height = (windowSize.Height - windowSize.Width / desiredAspect) / 2.f;
-		}
-	}
+	// calculate window viewport to maintain aspect ratio.
+	viewport = fitViewport(0.f, 0.f, windowSize.Width, windowSize.Height);
 
 	if (swapChain != nullptr) {
 		// Resize swap chain buffers.
@@ -109,7 +109,7 @@ void Renderer::initWindowResources() {
 			lround(windowSize.Width),
 			lround(windowSize.Height),
 			DXGI_FORMAT_B8G8R8A8_UNORM,
-			0)
+			DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)
 		);
 
 		// Construct a bitmap descriptor that is used with Direct2D rendering.
@@ -160,7 +160,7 @@ void Renderer::initWindowResources() {
 		descriptor.BufferCount = 2;
 		descriptor.Scaling = DXGI_SCALING_NONE;
 		descriptor.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD; // FLIP mode is mandatory!
-		descriptor.Flags = 0;
+		descriptor.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
 		// Create a swap chain for the window.
 		check_hresult(dxgiFactory->CreateSwapChainForCoreWindow(
@@ -171,6 +171,11 @@ void Renderer::initWindowResources() {
 			swapChain.put()
 		));
 
+		// Limit the queue to a single frame and fetch the object that is signaled when a new frame can be rendered.
+		auto swapChain2 = swapChain.as<IDXGISwapChain2>();
+		check_hresult(swapChain2->SetMaximumFrameLatency(1));
+		frameLatencyWaitable.attach(swapChain2->GetFrameLatencyWaitableObject());
+
 		// Construct a bitmap descriptor that is used with Direct2D rendering.
 		D2D1_BITMAP_PROPERTIES1 properties{};
 		properties.bitmapOptions |= D2D1_BITMAP_OPTIONS_TARGET;
@@ -202,73 +207,173 @@ void Renderer::setWindow(const ApplicationWindow& newWindow) {
 	windowSize = Size(newWindow.Bounds().Width, newWindow.Bounds().Height);
 	dpi = DisplayInformation::GetForCurrentView().LogicalDpi();
 	d2dDeviceCtx->SetDpi(dpi, dpi);
+	resizer.reset({ windowSize.Width, windowSize.Height, dpi });
 	initWindowResources();
 }
 
 void Renderer::setWindowSize(const Size& size) {
-	if (windowSize != size) {
-		windowSize = size;
-		initWindowResources();
-	}
+	// Only record the new size as a window drag produces a storm of these. The resize is applied with the next frame.
+	resizer.requestSize(size.Width, size.Height);
 }
 
 void Renderer::setDpi(float newDpi) {
-	if (newDpi != dpi) {
-		dpi = newDpi;
-		windowSize = Size(window.get().Bounds().Width, window.get().Bounds().Height);
+	// The window size in device independent pixels may change along with the DPI.
+	const auto bounds = window.get().Bounds();
+	resizer.requestDpi(newDpi);
+	resizer.requestSize(bounds.Width, bounds.Height);
+}
+
+void Renderer::resize(const ResizeCoalescer::Target& target) {
+	if (target.dpi != dpi) {
+		dpi = target.dpi;
 		d2dDeviceCtx->SetDpi(dpi, dpi);
-		initWindowResources();
+	}
+	windowSize = Size(target.width, target.height);
+	initWindowResources();
+}
+
+void Renderer::waitForFrame() const {
+	constexpr auto MaxWaitTimeMS = 1000;
+	if (frameLatencyWaitable) {
+		WaitForSingleObjectEx(frameLatencyWaitable.get(), MaxWaitTimeMS, true);
 	}
 }
 
 void Renderer::clear() {
+	resizer.apply();
 	d2dDeviceCtx->BeginDraw();
 	d2dDeviceCtx->Clear(D2D1::ColorF(D2D1::ColorF::Black));
 }
 
-void Renderer::present() {
+void Renderer::setRecorder(Recorder* newRecorder) {
+	recorder = newRecorder;
+	captureSlots = {};
+}
+
+auto Renderer::present() -> bool {
 	check_hresult(d2dDeviceCtx->EndDraw());
+	if (recorder) {
+		capture();
+	}
 	auto presentResult = swapChain->Present(1, 0);
 
 	// Recreate our resources whether the GPU was disconnected or went to a errorneous state.
 	if (presentResult == DXGI_ERROR_DEVICE_REMOVED || presentResult == DXGI_ERROR_DEVICE_RESET) {
 		initDeviceResources();
 		initWindowResources();
-	} else {
-		check_hresult(presentResult);
+		return false;
 	}
+	check_hresult(presentResult);
+	return true;
 }
 
-void Renderer::draw(com_ptr<ID2D1Brush> brush, const Rectangle& rect) const {
+void Renderer::capture() {
+	// Hand over the oldest captured frames whose copies the GPU has already completed. Never wait for the GPU.
+	for (auto i = 0u; i < captureSlots.size(); i++) {
+		auto& slot = captureSlots[(captureIndex + i) % captureSlots.size()];
+		if (!slot.pending) {
+			continue;
+		}
+		D3D11_MAPPED_SUBRESOURCE mapped{};
+		auto result = d3dDeviceCtx->Map(slot.texture.get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+		if (result == DXGI_ERROR_WAS_STILL_DRAWING) {
+			break;
+		}
+		check_hresult(result);
+		D3D11_TEXTURE2D_DESC descriptor{};
+		slot.texture->GetDesc(&descriptor);
+		recorder->submit(static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch, descriptor.Width, descriptor.Height, slot.timestamp);
+		d3dDeviceCtx->Unmap(slot.texture.get(), 0);
+		slot.pending = false;
+	}
+
+	// Query the back buffer that contains the frame that is about to be presented.
+	com_ptr<ID3D11Texture2D> backBuffer;
+	check_hresult(swapChain->GetBuffer(0, IID_PPV_ARGS(&backBuffer)));
+
+	// Copy the frame into the next staging texture. The frame in it is lost whether it hasn't been read back yet.
+	auto& slot = captureSlots[captureIndex];
+	if (slot.pending) {
+		recorder->drop();
+	}
+	if (!slot.texture) {
+		D3D11_TEXTURE2D_DESC descriptor{};
+		backBuffer->GetDesc(&descriptor);
+		descriptor.Usage = D3D11_USAGE_STAGING;
+		descriptor.BindFlags = 0;
+		descriptor.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		descriptor.MiscFlags = 0;
+		check_hresult(d3dDevice->CreateTexture2D(&descriptor, nullptr, slot.texture.put()));
+	}
+	d3dDeviceCtx->CopyResource(slot.texture.get(), backBuffer.get());
+	slot.timestamp = Recorder::Clock::now();
+	slot.pending = true;
+	captureIndex = (captureIndex + 1) % captureSlots.size();
+}
+
+void Renderer::draw(ID2D1Brush* brush, const Rectangle& rect) const {
+	fill(brush, rect, viewport);
+}
+
+void Renderer::draw(ID2D1Brush* brush, const Text& text) const {
+	// Opacity masks can only be filled with aliased antialiasing mode.
+	d2dDeviceCtx->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+	fill(brush, text, viewport);
+	d2dDeviceCtx->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+}
+
+void Renderer::draw(const Scene& scene) const {
+	for (const auto& shape : scene.shapes) {
+		draw(getBrush(shape.brush), shape.rectangle);
+	}
+	for (const auto& label : scene.labels) {
+		draw(getBrush(label.brush), label.text);
+	}
+}
+
+auto Renderer::fitViewport(float left, float top, float width, float height) -> Viewport {
+	constexpr auto DesiredAspect = 1.3f;
+	auto result = Viewport{ left, top, width, height };
+	const auto aspect = width / height;
+	if (aspect > DesiredAspect) {
+		result.width = DesiredAspect * height;
+		result.left += (width - result.width) / 2.f;
+	} else if (aspect < DesiredAspect) {
+		result.height = width / DesiredAspect;
+		result.top += (height - result.height) / 2.f;
+	}
+	return result;
+}
+
+void Renderer::fill(ID2D1Brush* brush, const Rectangle& rect, const Viewport& area) const {
+	const auto left = static_cast<float>(-rect.extent.x + rect.position.x);
+	const auto top = static_cast<float>(-rect.extent.y + rect.position.y);
+	const auto right = static_cast<float>(rect.extent.x + rect.position.x);
+	const auto bottom = static_cast<float>(rect.extent.y + rect.position.y);
 	d2dDeviceCtx->FillRectangle({
-	windowOffset.Width + (-rect.extent.x + rect.position.x) * (windowSize.Width - windowOffset.Width * 2),
-	windowOffset.Height + (-rect.extent.y + rect.position.y) * (windowSize.Height - windowOffset.Height * 2),
-	windowOffset.Width + (rect.extent.x + rect.position.x) * (windowSize.Width - windowOffset.Width * 2),
-	windowOffset.Height + (rect.extent.y + rect.position.y) * (windowSize.Height - windowOffset.Height * 2),
-		}, brush.get());
+	area.left + left * area.width,
+	area.top + top * area.height,
+	area.left + right * area.width,
+	area.top + bottom * area.height,
+		}, brush);
 }
 
-void Renderer::draw(com_ptr<ID2D1Brush> brush, const Text& text) const {
-	auto size = text.fontSize * (windowSize.Height - windowOffset.Height * 2.f);
-	com_ptr<IDWriteTextFormat> format;
-	dWriteFactory->CreateTextFormat(
-		L"Calibri",
-		nullptr,
-		DWRITE_FONT_WEIGHT_REGULAR,
-		DWRITE_FONT_STYLE_NORMAL,
-		DWRITE_FONT_STRETCH_NORMAL,
-		size,
-		L"en-us",
-		format.put()
-	);
-	format->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
-	auto x = windowOffset.Width + text.position.x * (windowSize.Width - windowOffset.Width * 2);
-	auto y = windowOffset.Height + text.position.y * (windowSize.Height - windowOffset.Height * 2);
-	d2dDeviceCtx->DrawText(
-		text.text.c_str(),
-		UINT32(text.text.size()),
-		format.get(),
-		{ x - text.text.length() * size * .5f,y,x + text.text.length() * size * .5f,y },
-		brush.get()
-	);
+void Renderer::fill(ID2D1Brush* brush, const Text& text, const Viewport& area) const {
+	const auto& atlas = getGlyphAtlas(text.fontSize * area.height, text.text);
+	auto x = area.left + static_cast<float>(text.position.x) * area.width;
+	auto y = area.top + static_cast<float>(text.position.y) * area.height;
+	atlas.drawCentered(d2dDeviceCtx.get(), brush, text.text, { x, y });
+}
+
+auto Renderer::getGlyphAtlas(float fontSize, std::wstring_view text) const -> const D2DGlyphAtlas& {
+	// Rebuild the atlas of the font size with the new glyphs when the text uses glyphs it doesn't contain yet.
+	for (auto& atlas : glyphAtlases) {
+		if (atlas.getFontSize() == fontSize) {
+			if (!atlas.contains(text)) {
+				atlas = D2DGlyphAtlas(d2dDeviceCtx.get(), dWriteFactory.get(), fontSize, atlas.getCharacters() + std::wstring(text));
+			}
+			return atlas;
+		}
+	}
+	return glyphAtlases.emplace_back(d2dDeviceCtx.get(), dWriteFactory.get(), fontSize, text);
 }
\ No newline at end of file
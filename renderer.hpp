@@ -1,42 +1,31 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <d2d1.h>
 #include <d2d1_3.h>
 #include <d3d11.h>
 #include <dxgi1_3.h>
+#include <string_view>
+#include <vector>
 #include <winrt/Windows.Foundation.h>
 #include <winrt/Windows.UI.Core.h>
 
+#include "diagnostics.hpp"
+#include "d2dglyphatlas.hpp"
+#include "recorder.hpp"
+#include "resizecoalescer.hpp"
+#include "scene.hpp"
+
 // An alias for the CoreWindow to avoid using the full name monster.
 using ApplicationWindow = winrt::Windows::UI::Core::CoreWindow;
 
-// Vec2f represents a 2D vector with floating point values.
-struct Vec2f final {
-	auto operator+(const Vec2f& v) const -> Vec2f { return { x + v.x, y + v.y }; }
-	auto operator-(const Vec2f& v) const -> Vec2f { return { x - v.x, y - v.y }; }
-
-	void operator+=(const Vec2f& v) { x += v.x; y += v.y; }
-	void operator-=(const Vec2f& v) { x -= v.x; y -= v.y; }
-
-	auto operator*(float s) const -> Vec2f { return { x * s, y * s }; }
-
-	float x;
-	float y;
-};
-
-struct Rectangle {
-	Vec2f extent = { 0.f, 0.f };
-	Vec2f position = { 0.f, 0.f };
-	Vec2f velocity = { 0.f, 0.f };
-};
-
-struct Text {
-	Vec2f		 position = { 0.f,0.f };
-	std::wstring text;
-	float		 fontSize = 0.f;
-};
+// The renderer keeps its COM objects in pointers whose copies are counted, so that the frame path can be checked for
+// reference count operations.
+template <typename T>
+using ComPtr = Diagnostics::Counted<winrt::com_ptr<T>>;
 
-class Renderer {
+class Renderer : private ResizeCoalescer::Device {
 public:
 	Renderer();
 
@@ -46,29 +35,64 @@ public:
 	void setWindow(const ApplicationWindow& window);
 	void setWindowSize(const winrt::Windows::Foundation::Size& size);
 	void setDpi(float dpi);
+	void setRecorder(Recorder* recorder);
+	auto getResizeStatistics() const -> const ResizeCoalescer::Statistics& { return resizer.getStatistics(); }
 
+	void waitForFrame() const;
 	void clear();
-	void present();
+	auto present() -> bool;
 
-	winrt::com_ptr<ID2D1Brush> getWhiteBrush() const { return whiteBrush; }
-	winrt::com_ptr<ID2D1Brush> getBlackBrush() const { return blackBrush; }
+	ID2D1Brush* getWhiteBrush() const { return whiteBrush.get(); }
+	ID2D1Brush* getBlackBrush() const { return blackBrush.get(); }
+	ID2D1Brush* getBrush(Scene::Brush brush) const { return brush == Scene::Brush::BLACK ? getBlackBrush() : getWhiteBrush(); }
 
-	void draw(winrt::com_ptr<ID2D1Brush> brush, const Rectangle& rect) const;
-	void draw(winrt::com_ptr<ID2D1Brush> brush, const Text& text) const;
+	void draw(ID2D1Brush* brush, const Rectangle& rect) const;
+	void draw(ID2D1Brush* brush, const Text& text) const;
+	void draw(const Scene& scene) const;
 
 private:
+	// Viewport is the area of the target where the normalized game coordinates are mapped into.
+	struct Viewport {
+		float left;
+		float top;
+		float width;
+		float height;
+	};
+
+	struct CaptureSlot {
+		ComPtr<ID3D11Texture2D>     texture;
+		Recorder::Clock::time_point timestamp;
+		bool                        pending = false;
+	};
+
+	static auto fitViewport(float left, float top, float width, float height) -> Viewport;
+
+	void fill(ID2D1Brush* brush, const Rectangle& rect, const Viewport& area) const;
+	void fill(ID2D1Brush* brush, const Text& text, const Viewport& area) const;
+
+	auto getGlyphAtlas(float fontSize, std::wstring_view text) const -> const D2DGlyphAtlas&;
+	void capture();
+	void resize(const ResizeCoalescer::Target& target) override;
+
 	winrt::agile_ref<ApplicationWindow>  window;
 	winrt::Windows::Foundation::Size	 windowSize;
-	winrt::Windows::Foundation::Size	 windowOffset = { 0,0 };
+	Viewport							 viewport = { 0,0,0,0 };
 	float								 dpi = 0.f;
-
-	winrt::com_ptr<ID3D11Device>		 d3dDevice;
-	winrt::com_ptr<ID3D11DeviceContext>  d3dDeviceCtx;
-	winrt::com_ptr<ID2D1Factory6>		 d2dFactory;
-	winrt::com_ptr<ID2D1Device5>		 d2dDevice;
-	winrt::com_ptr<ID2D1DeviceContext5>  d2dDeviceCtx;
-	winrt::com_ptr<IDXGISwapChain1>		 swapChain;
-	winrt::com_ptr<IDWriteFactory3>		 dWriteFactory;
-	winrt::com_ptr<ID2D1SolidColorBrush> whiteBrush;
-	winrt::com_ptr<ID2D1SolidColorBrush> blackBrush;
+	SteadyClock							 resizeClock;
+	ResizeCoalescer						 resizer{ *this, resizeClock };
+
+	ComPtr<ID3D11Device>				 d3dDevice;
+	ComPtr<ID3D11DeviceContext>			 d3dDeviceCtx;
+	ComPtr<ID2D1Factory6>				 d2dFactory;
+	ComPtr<ID2D1Device5>				 d2dDevice;
+	ComPtr<ID2D1DeviceContext5>			 d2dDeviceCtx;
+	ComPtr<IDXGISwapChain1>				 swapChain;
+	winrt::handle						 frameLatencyWaitable;
+	ComPtr<IDWriteFactory3>				 dWriteFactory;
+	ComPtr<ID2D1SolidColorBrush>		 whiteBrush;
+	ComPtr<ID2D1SolidColorBrush>		 blackBrush;
+	mutable std::vector<D2DGlyphAtlas>	 glyphAtlases;
+	Recorder*							 recorder = nullptr;
+	std::array<CaptureSlot, 3>			 captureSlots;
+	int									 captureIndex = 0;
 };
\ No newline at end of file
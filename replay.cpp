@@ -0,0 +1,273 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace Replay;
+
+namespace {
+	// TickRecord is the stored layout of a single tick.
+	struct TickRecord {
+		int8_t   player1Movement;
+		int8_t   player2Movement;
+		uint8_t  start;
+		uint8_t  deltaMS;
+		uint32_t reserved;
+		uint64_t hash;
+	};
+	static_assert(sizeof(TickRecord) == 16, "replay ticks must have a stable layout");
+
+	// Simulate the match and pass the state hash of each tick to the visitor until it returns false. Replayed games
+	// don't log telemetry as the events were already logged when the match was played.
+	template <typename Visitor>
+	void simulate(const Match& match, Visitor visit) {
+		Game game{ match.seed, false };
+		for (auto i = size_t(0); i < match.ticks.size(); i++) {
+			const auto& tick = match.ticks[i];
+			game.onInput(tick.input);
+			game.update(std::chrono::milliseconds(tick.deltaMS));
+			if (!visit(i, game.getStateHash())) {
+				return;
+			}
+		}
+	}
+}
+
+void Replay::record(Match& match, const Game& game, const Game::Input& input, std::chrono::milliseconds delta) {
+	match.ticks.push_back({ input, static_cast<uint8_t>(delta.count()), game.getStateHash() });
+}
+
+void Replay::record(Match& match) {
+	simulate(match, [&match](size_t tick, uint64_t hash) {
+		match.ticks[tick].hash = hash;
+		return true;
+	});
+}
+
+auto Replay::verify(const std::vector<Match>& corpus) -> std::vector<Mismatch> {
+	// Matches are independent of each other so they are spread over all cores. Each match writes only its own slot.
+	auto results = std::vector<Mismatch>(corpus.size());
+	auto diverged = std::vector<uint8_t>(corpus.size());
+	auto nextMatch = std::atomic<size_t>{ 0 };
+	const auto verifyMatches = [&]() {
+		for (auto i = nextMatch++; i < corpus.size(); i = nextMatch++) {
+			const auto& match = corpus[i];
+			simulate(match, [&](size_t tick, uint64_t hash) {
+				if (hash == match.ticks[tick].hash) {
+					return true;
+				}
+				results[i] = { i, tick, match.ticks[tick].hash, hash };
+				diverged[i] = 1;
+				return false;
+			});
+		}
+	};
+	auto workers = std::vector<std::thread>{};
+	const auto workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), corpus.size());
+	for (auto i = size_t(1); i < workerCount; i++) {
+		workers.emplace_back(verifyMatches);
+	}
+	verifyMatches();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	auto mismatches = std::vector<Mismatch>{};
+	for (auto i = size_t(0); i < corpus.size(); i++) {
+		if (diverged[i]) {
+			mismatches.push_back(results[i]);
+		}
+	}
+	return mismatches;
+}
+
+auto Replay::save(const std::filesystem::path& filename, const std::vector<Match>& corpus) -> bool {
+	auto writer = Writer{ filename, static_cast<uint32_t>(corpus.size()) };
+	for (const auto& match : corpus) {
+		writer.write(match);
+	}
+	return writer.isGood();
+}
+
+auto Replay::load(const std::filesystem::path& filename, std::vector<Match>& corpus) -> bool {
+	auto reader = Reader{ filename };
+	return reader.isOpen() && reader.read(corpus, reader.getMatchCount());
+}
+
+Writer::Writer(const std::filesystem::path& filename, uint32_t matchCount) : file(filename, std::ios::binary | std::ios::trunc) {
+	for (const auto value : { Magic, Version, matchCount }) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+}
+
+auto Writer::write(const Match& match) -> bool {
+	const auto write = [this](uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+	write(match.seed);
+	write(static_cast<uint32_t>(match.ticks.size()));
+	for (const auto& tick : match.ticks) {
+		const auto record = TickRecord{ tick.input.player1Movement, tick.input.player2Movement, tick.input.start, tick.deltaMS, 0, tick.hash };
+		file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	}
+	return isGood();
+}
+
+Reader::Reader(const std::filesystem::path& filename) : file(filename, std::ios::binary) {
+	uint32_t header[3] = {};
+	file.read(reinterpret_cast<char*>(header), sizeof(header));
+	open = file && header[0] == Magic && header[1] == Version;
+	matchCount = open ? header[2] : 0;
+}
+
+auto Reader::read(std::vector<Match>& matches, size_t maxCount) -> bool {
+	const auto read = [this]() {
+		auto value = uint32_t(0);
+		file.read(reinterpret_cast<char*>(&value), sizeof(value));
+		return value;
+	};
+	auto records = std::vector<TickRecord>{};
+	for (auto i = size_t(0); i < maxCount && readMatches < matchCount && file; i++, readMatches++) {
+		auto& match = matches.emplace_back();
+		match.seed = read();
+		records.resize(read());
+		file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TickRecord));
+		match.ticks.reserve(records.size());
+		for (const auto& record : records) {
+			auto tick = Tick{};
+			tick.input.player1Movement = record.player1Movement;
+			tick.input.player2Movement = record.player2Movement;
+			tick.input.start = record.start != 0;
+			tick.deltaMS = record.deltaMS;
+			tick.hash = record.hash;
+			match.ticks.push_back(tick);
+		}
+	}
+	return open && static_cast<bool>(file);
+}
+
+Session::Session(const std::filesystem::path& sessionFilename, unsigned int seed)
+	: filename(sessionFilename), file(sessionFilename, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc),
+	blocks(BlockCount) {
+	// The file starts as a replay of a single match without ticks.
+	for (const auto value : { Magic, Version, 1u, static_cast<uint32_t>(seed), 0u }) {
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+	file.flush();
+	open = static_cast<bool>(file);
+	for (auto i = size_t(0); i < BlockCount; i++) {
+		freeBlocks[freeCount++] = i;
+	}
+	copies.reserve(BlockCount);
+	writer = std::thread(&Session::run, this);
+}
+
+Session::~Session() {
+	if (current != NoBlock && blocks[current].count > 0) {
+		queueCurrentBlock();
+	}
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		running = false;
+	}
+	condition.notify_all();
+	writer.join();
+}
+
+void Session::record(const Game& game, const Game::Input& input, std::chrono::milliseconds delta) {
+	if (!open || droppedTicks > 0 || (current == NoBlock && !takeFreeBlock())) {
+		droppedTicks++;
+		return;
+	}
+	auto& block = blocks[current];
+	block.ticks[block.count++] = { input, static_cast<uint8_t>(delta.count()), game.getStateHash() };
+	recordedTicks++;
+	if (block.count == BlockTicks) {
+		queueCurrentBlock();
+	}
+}
+
+void Session::save(const std::filesystem::path& copyFilename) {
+	// Hand over the partially filled block instead of copying it, the next step simply takes a free block.
+	if (current != NoBlock && blocks[current].count > 0) {
+		queueCurrentBlock();
+	}
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		copies.push_back(copyFilename);
+	}
+	condition.notify_all();
+}
+
+void Session::flush() {
+	if (current != NoBlock && blocks[current].count > 0) {
+		queueCurrentBlock();
+	}
+	std::unique_lock<std::mutex> lock{ mutex };
+	condition.wait(lock, [this] { return queueCount == 0 && copies.empty() && !writing; });
+}
+
+auto Session::takeFreeBlock() -> bool {
+	std::lock_guard<std::mutex> lock{ mutex };
+	if (freeCount == 0) {
+		return false;
+	}
+	current = freeBlocks[--freeCount];
+	blocks[current].count = 0;
+	return true;
+}
+
+void Session::queueCurrentBlock() {
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		queuedBlocks[(queueStart + queueCount++) % BlockCount] = current;
+	}
+	current = NoBlock;
+	condition.notify_all();
+}
+
+void Session::run() {
+	// Blocks are written before the copies, so a copy contains at least the ticks recorded before it was requested.
+	auto lock = std::unique_lock<std::mutex>{ mutex };
+	while (true) {
+		condition.wait(lock, [this] { return queueCount > 0 || !copies.empty() || !running; });
+		if (queueCount > 0) {
+			const auto index = queuedBlocks[queueStart];
+			queueStart = (queueStart + 1) % BlockCount;
+			queueCount--;
+			writing = true;
+			lock.unlock();
+			append(blocks[index]);
+			lock.lock();
+			writtenTicks += blocks[index].count;
+			freeBlocks[freeCount++] = index;
+		} else if (!copies.empty()) {
+			const auto copy = copies.front();
+			copies.erase(copies.begin());
+			writing = true;
+			lock.unlock();
+			auto error = std::error_code{};
+			std::filesystem::copy_file(filename, copy, std::filesystem::copy_options::overwrite_existing, error);
+			lock.lock();
+		} else {
+			break;
+		}
+		writing = false;
+		condition.notify_all();
+	}
+}
+
+void Session::append(const Block& block) {
+	// Append the ticks and only then count them in the header, so that the file stays valid if the game stops.
+	auto records = std::array<TickRecord, BlockTicks>{};
+	for (auto i = size_t(0); i < block.count; i++) {
+		const auto& tick = block.ticks[i];
+		records[i] = { tick.input.player1Movement, tick.input.player2Movement, tick.input.start, tick.deltaMS, 0, tick.hash };
+	}
+	file.seekp(0, std::ios::end);
+	file.write(reinterpret_cast<const char*>(records.data()), block.count * sizeof(TickRecord));
+	constexpr auto TickCountOffset = 4 * sizeof(uint32_t);
+	const auto tickCount = static_cast<uint32_t>(writtenTicks + block.count);
+	file.seekp(TickCountOffset);
+	file.write(reinterpret_cast<const char*>(&tickCount), sizeof(tickCount));
+	file.flush();
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "game.hpp"
+
+// Replays are recorded matches that are used to verify that changes to the simulation keep old matches intact.
+//
+// A replay consists of the seed of the game and the input, the step duration and the resulting state hash of each
+// simulation step. A replay file is laid out as
+//
+//   magic | version | match count | for each match: seed | tick count | ticks
+namespace Replay {
+	constexpr auto Magic = 0x594c5052u; // "RPLY"
+	constexpr auto Version = 1u;
+
+	struct Tick {
+		Game::Input input;
+		uint8_t     deltaMS = 0;
+		uint64_t    hash = 0;
+	};
+
+	struct Match {
+		unsigned int      seed = std::default_random_engine::default_seed;
+		std::vector<Tick> ticks;
+	};
+
+	// Mismatch tells the first step of a match where the simulation diverged from the recorded one.
+	struct Mismatch {
+		size_t   match;
+		size_t   tick;
+		uint64_t expectedHash;
+		uint64_t actualHash;
+	};
+
+	// Appends a step that the game has just simulated to the match. Steps must not be longer than 255 milliseconds.
+	void record(Match& match, const Game& game, const Game::Input& input, std::chrono::milliseconds delta);
+
+	// Simulates the match and stores the resulting state hashes into its ticks.
+	void record(Match& match);
+
+	// Simulates the matches on all cores and returns the mismatches in the order of the matches.
+	auto verify(const std::vector<Match>& corpus) -> std::vector<Mismatch>;
+
+	auto save(const std::filesystem::path& filename, const std::vector<Match>& corpus) -> bool;
+	auto load(const std::filesystem::path& filename, std::vector<Match>& corpus) -> bool;
+
+	// Writer writes a known amount of matches one at a time, so that a large corpus doesn't need to fit in memory.
+	class Writer final {
+	public:
+		Writer(const std::filesystem::path& filename, uint32_t matchCount);
+		auto write(const Match& match) -> bool;
+		auto isGood() const -> bool { return static_cast<bool>(file); }
+	private:
+		std::ofstream file;
+	};
+
+	// Reader reads the matches of a replay file in batches, so that a large corpus doesn't need to fit in memory.
+	class Reader final {
+	public:
+		explicit Reader(const std::filesystem::path& filename);
+		auto isOpen() const -> bool { return open; }
+		auto getMatchCount() const -> uint32_t { return matchCount; }
+		auto read(std::vector<Match>& matches, size_t maxCount) -> bool;
+	private:
+		std::ifstream file;
+		bool          open = false;
+		uint32_t      matchCount = 0;
+		uint32_t      readMatches = 0;
+	};
+
+	// Session streams the steps of a live game into a replay file of a single match, so that the memory it takes
+	// stays the same however long the game runs. Recording a step neither allocates nor waits for the disk: steps are
+	// collected into preallocated blocks that a background thread appends to the file, which is a valid replay of
+	// every block written so far. If the disk falls behind by all of the blocks, the session stops recording, as a
+	// replay with missing steps could not be simulated. The caller must not record and save at the same time.
+	class Session final {
+	public:
+		static constexpr auto BlockTicks = size_t(1024);
+		static constexpr auto BlockCount = size_t(4);
+
+		Session(const std::filesystem::path& filename, unsigned int seed);
+		~Session();
+		Session(const Session&) = delete;
+		auto operator=(const Session&) -> Session& = delete;
+
+		auto isOpen() const -> bool { return open; }
+		void record(const Game& game, const Game::Input& input, std::chrono::milliseconds delta);
+		// Copies the steps recorded so far into another replay file in the background.
+		void save(const std::filesystem::path& filename);
+		// Waits until the steps recorded and the copies requested so far have been written.
+		void flush();
+		auto getRecordedTicks() const -> uint64_t { return recordedTicks; }
+		auto getDroppedTicks() const -> uint64_t { return droppedTicks; }
+	private:
+		struct Block {
+			std::array<Tick, BlockTicks> ticks;
+			size_t                       count = 0;
+		};
+
+		static constexpr auto NoBlock = BlockCount;
+
+		auto takeFreeBlock() -> bool;
+		void queueCurrentBlock();
+		void run();
+		void append(const Block& block);
+
+		std::filesystem::path               filename;
+		std::fstream                        file;
+		bool                                open = false;
+		std::vector<Block>                  blocks;
+		size_t                              current = NoBlock;
+		uint64_t                            recordedTicks = 0;
+		uint64_t                            droppedTicks = 0;
+		uint64_t                            writtenTicks = 0;
+		std::array<size_t, BlockCount>      freeBlocks = {};
+		size_t                              freeCount = 0;
+		std::array<size_t, BlockCount>      queuedBlocks = {};
+		size_t                              queueStart = 0;
+		size_t                              queueCount = 0;
+		std::vector<std::filesystem::path>  copies;
+		bool                                writing = false;
+		bool                                running = true;
+		std::mutex                          mutex;
+		std::condition_variable             condition;
+		std::thread                         writer;
+	};
+}
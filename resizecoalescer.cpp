@@ -0,0 +1,39 @@
+#include "resizecoalescer.hpp"
+
+ResizeCoalescer::ResizeCoalescer(Device& device, Clock& clock) : device(device), clock(clock) {
+}
+
+void ResizeCoalescer::reset(const Target& newTarget) {
+	target = newTarget;
+	pendingTarget = newTarget;
+	pending = false;
+}
+
+void ResizeCoalescer::requestSize(float width, float height) {
+	pendingTarget.width = width;
+	pendingTarget.height = height;
+	pending = true;
+	statistics.requests++;
+}
+
+void ResizeCoalescer::requestDpi(float dpi) {
+	pendingTarget.dpi = dpi;
+	pending = true;
+	statistics.requests++;
+}
+
+auto ResizeCoalescer::apply() -> bool {
+	// Changes that cancel each other out, such as dragging the window back to its size, don't need a rebuild.
+	if (!pending || pendingTarget == target) {
+		pending = false;
+		return false;
+	}
+
+	const auto startTime = clock.now();
+	target = pendingTarget;
+	pending = false;
+	device.resize(target);
+	statistics.resizes++;
+	statistics.stallTime += clock.now() - startTime;
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "scheduler.hpp"
+
+// ResizeCoalescer collapses the window size and DPI changes between two frames into a single rebuild.
+//
+// A window drag produces a storm of size changes. They are only recorded as they arrive and the latest of them is
+// applied once at the start of the next frame, so the current target keeps presenting until then.
+class ResizeCoalescer final {
+public:
+	// Target is the window size in device independent pixels and the DPI that the window resources are built for.
+	struct Target {
+		float width = 0.f;
+		float height = 0.f;
+		float dpi = 0.f;
+
+		auto operator==(const Target& rhs) const -> bool { return width == rhs.width && height == rhs.height && dpi == rhs.dpi; }
+		auto operator!=(const Target& rhs) const -> bool { return !(*this == rhs); }
+	};
+
+	// Device rebuilds the window resources for a new target.
+	class Device {
+	public:
+		virtual ~Device() = default;
+		virtual void resize(const Target& target) = 0;
+	};
+
+	// Statistics tells how many changes were requested, how many rebuilds they caused and how long the rebuilds took.
+	struct Statistics {
+		long long       requests = 0;
+		long long       resizes = 0;
+		Clock::Duration stallTime = Clock::Duration::zero();
+	};
+
+	ResizeCoalescer(Device& device, Clock& clock);
+
+	void reset(const Target& target);
+	void requestSize(float width, float height);
+	void requestDpi(float dpi);
+	auto apply() -> bool;
+
+	auto isPending() const -> bool { return pending; }
+	auto getTarget() const -> const Target& { return target; }
+	auto getStatistics() const -> const Statistics& { return statistics; }
+private:
+	Device&    device;
+	Clock&     clock;
+	Target     target;
+	Target     pendingTarget;
+	bool       pending = false;
+	Statistics statistics;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "fixed.hpp"
+
+// Scalar is the numeric type of the simulation. Define PONG_FIXED_POINT to use deterministic fixed-point numbers.
+#if defined(PONG_FIXED_POINT)
+using Scalar = Fixed;
+#else
+using Scalar = float;
+#endif
+
+// Vec2f represents a 2D vector with simulation scalar values.
+struct Vec2f final {
+	auto operator+(const Vec2f& v) const -> Vec2f { return { x + v.x, y + v.y }; }
+	auto operator-(const Vec2f& v) const -> Vec2f { return { x - v.x, y - v.y }; }
+
+	void operator+=(const Vec2f& v) { x += v.x; y += v.y; }
+	void operator-=(const Vec2f& v) { x -= v.x; y -= v.y; }
+
+	auto operator*(Scalar s) const -> Vec2f { return { x * s, y * s }; }
+
+	Scalar x;
+	Scalar y;
+};
+
+struct Rectangle {
+	Vec2f extent = { 0.f, 0.f };
+	Vec2f position = { 0.f, 0.f };
+	Vec2f velocity = { 0.f, 0.f };
+};
+
+struct Text {
+	Vec2f			  position = { 0.f,0.f };
+	std::wstring_view text;
+	float			  fontSize = 0.f;
+};
+
+// Scene is a snapshot of everything that should be drawn within a single frame.
+struct Scene {
+	enum class Brush { WHITE, BLACK };
+
+	struct Shape {
+		Brush     brush;
+		Rectangle rectangle;
+	};
+
+	struct Label {
+		Brush brush;
+		Text  text;
+	};
+
+	Scene() { shapes.reserve(16); labels.reserve(8); }
+
+	void clear() { shapes.clear(); labels.clear(); }
+	void add(Brush brush, const Rectangle& rectangle) { shapes.push_back({ brush, rectangle }); }
+	void add(Brush brush, const Text& text) { labels.push_back({ brush, text }); }
+
+	std::vector<Shape> shapes;
+	std::vector<Label> labels;
+};
\ No newline at end of file
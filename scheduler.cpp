@@ -0,0 +1,119 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+using namespace std::chrono;
+
+// The amount of time before the deadline where we stop sleeping and start spinning.
+constexpr auto SpinThreshold = 2ms;
+
+SteadyClock::SteadyClock() {
+	#if defined(_WIN32)
+	timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	#endif
+}
+
+SteadyClock::~SteadyClock() {
+	#if defined(_WIN32)
+	if (timer) {
+		CloseHandle(timer);
+	}
+	#endif
+}
+
+void SteadyClock::sleep(Duration duration) {
+	#if defined(_WIN32)
+	// Relative due times are given as negative amounts of 100 nanosecond intervals.
+	if (timer) {
+		LARGE_INTEGER dueTime = {};
+		dueTime.QuadPart = -std::max<long long>(1, duration.count() / 100);
+		if (SetWaitableTimerEx(timer, &dueTime, 0, nullptr, nullptr, nullptr, 0)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+	#endif
+	std::this_thread::sleep_for(duration);
+}
+
+void SteadyClock::yield() {
+	std::this_thread::yield();
+}
+
+FrameScheduler::FrameScheduler(Clock& clockRef, double targetRate) : clock(clockRef) {
+	setTargetRate(targetRate);
+	previousTime = clock.now();
+	deadline = previousTime;
+}
+
+void FrameScheduler::setTargetRate(double rate) {
+	if (rate > 0.0) {
+		targetFrameTime = duration_cast<Clock::Duration>(duration<double>(1.0 / rate));
+	} else {
+		targetFrameTime = Clock::Duration::zero();
+	}
+}
+
+auto FrameScheduler::waitForNextFrame() -> Clock::Duration {
+	// Wait until the deadline of the next frame. Sleeping is coarse so the last moments are spent spinning.
+	if (targetFrameTime > Clock::Duration::zero()) {
+		deadline += targetFrameTime;
+		const auto remaining = deadline - clock.now();
+		if (remaining > SpinThreshold) {
+			clock.sleep(remaining - SpinThreshold);
+		}
+		while (clock.now() < deadline) {
+			clock.yield();
+		}
+	}
+
+	// Resolve the duration of the previous frame.
+	const auto currentTime = clock.now();
+	const auto frameTime = currentTime - previousTime;
+	previousTime = currentTime;
+
+	// Resynchronize the deadline whether we fell behind by more than a frame to avoid a burst of catch-up frames.
+	if (currentTime - deadline > targetFrameTime) {
+		deadline = currentTime;
+	}
+
+	// Accumulate frame time statistics.
+	const auto ns = static_cast<double>(frameTime.count());
+	frames++;
+	sum += ns;
+	sumOfSquares += ns * ns;
+	minimum = std::min(minimum, frameTime);
+	maximum = std::max(maximum, frameTime);
+	return frameTime;
+}
+
+auto FrameScheduler::getStatistics() const -> Statistics {
+	auto stats = Statistics{};
+	stats.frames = frames;
+	if (frames > 0) {
+		const auto mean = sum / frames;
+		const auto variance = std::max(0.0, sumOfSquares / frames - mean * mean);
+		stats.average = Clock::Duration(static_cast<long long>(mean));
+		stats.jitter = Clock::Duration(static_cast<long long>(std::sqrt(variance)));
+		stats.minimum = minimum;
+		stats.maximum = maximum;
+	}
+	return stats;
+}
+
+void FrameScheduler::resetStatistics() {
+	frames = 0;
+	sum = 0.0;
+	sumOfSquares = 0.0;
+	minimum = Clock::Duration::max();
+	maximum = Clock::Duration::zero();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+
+// Clock is the time source used by the frame scheduler. It can be replaced with a virtual one for deterministic pacing.
+class Clock {
+public:
+	using Duration = std::chrono::nanoseconds;
+	using TimePoint = std::chrono::time_point<std::chrono::steady_clock, Duration>;
+
+	virtual ~Clock() = default;
+	virtual auto now() const -> TimePoint = 0;
+	virtual void sleep(Duration duration) = 0;
+	virtual void yield() = 0;
+};
+
+// SteadyClock is a monotonic high-resolution clock backed by the operating system.
+//
+// On Windows sleeping waits on a high-resolution waitable timer, as regular sleeps are rounded up to the system timer
+// resolution of up to 15.6 milliseconds.
+class SteadyClock final : public Clock {
+public:
+	SteadyClock();
+	~SteadyClock();
+	SteadyClock(const SteadyClock&) = delete;
+	auto operator=(const SteadyClock&) -> SteadyClock& = delete;
+
+	auto now() const -> TimePoint override { return std::chrono::steady_clock::now(); }
+	void sleep(Duration duration) override;
+	void yield() override;
+private:
+	void* timer = nullptr;
+};
+
+// VirtualClock is a manually driven clock where sleeping and yielding simply advance the time.
+class VirtualClock final : public Clock {
+public:
+	VirtualClock(Duration yieldStep = std::chrono::microseconds(1)) : step(yieldStep) {}
+	auto now() const -> TimePoint override { return time; }
+	void sleep(Duration duration) override { time += duration; }
+	void yield() override { time += step; }
+	void advance(Duration duration) { time += duration; }
+private:
+	TimePoint time;
+	Duration  step;
+};
+
+// FrameScheduler paces frames to a target rate by sleeping most of the wait and spinning the rest.
+class FrameScheduler final {
+public:
+	struct Statistics {
+		long long       frames = 0;
+		Clock::Duration average = Clock::Duration::zero();
+		Clock::Duration jitter = Clock::Duration::zero();
+		Clock::Duration minimum = Clock::Duration::max();
+		Clock::Duration maximum = Clock::Duration::zero();
+	};
+
+	FrameScheduler(Clock& clock, double targetRate = 0.0);
+
+	void setTargetRate(double rate);
+
+	auto waitForNextFrame() -> Clock::Duration;
+
+	auto getStatistics() const -> Statistics;
+	void resetStatistics();
+private:
+	Clock&           clock;
+	Clock::Duration  targetFrameTime = Clock::Duration::zero();
+	Clock::TimePoint previousTime;
+	Clock::TimePoint deadline;
+
+	long long        frames = 0;
+	double           sum = 0.0;
+	double           sumOfSquares = 0.0;
+	Clock::Duration  minimum = Clock::Duration::max();
+	Clock::Duration  maximum = Clock::Duration::zero();
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "framebuffer.hpp"
+#include "glyphatlas.hpp"
+
+// SoftwareGlyphAtlas is the software backend of GlyphAtlas for a single font size in pixels.
+//
+// There's no font rasterizer on every platform, so the glyphs come from a built-in 5x7 bitmap font that is scaled by
+// whole pixels to the font size. They are rasterized once into a coverage bitmap, and text is drawn by blending the
+// cells of its glyphs into a Framebuffer. When the glyphs don't fit the atlas, the dots of the font are filled instead.
+class SoftwareGlyphAtlas final {
+public:
+	SoftwareGlyphAtlas(float fontSize, std::wstring_view characters);
+
+	auto getFontSize() const -> float { return atlas.getFontSize(); }
+	auto getCharacters() const -> const std::wstring& { return atlas.getCharacters(); }
+	auto contains(std::wstring_view text) const -> bool { return atlas.contains(text); }
+	auto getAtlas() const -> const GlyphAtlas& { return atlas; }
+
+	// Draws the text with its top edge at y and centered on x.
+	void drawCentered(Framebuffer& framebuffer, uint32_t color, std::wstring_view text, float x, float y) const;
+private:
+	GlyphAtlas           atlas;
+	int                  scale = 1;
+	int                  width = 0;
+	std::vector<uint8_t> coverage;
+};
@@ -0,0 +1,210 @@
+#include "spectator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Spectator;
+
+// The number of bits each of the fields takes in the stream.
+constexpr int FieldBits[FIELD_COUNT] = { 2, 4, 4, 16, 16, 16, 16, 16, 16, 16, 16 };
+
+// The ranges positions and velocities are quantized from. Goals place the ball slightly outside of the court.
+constexpr auto MinPosition = -1.f;
+constexpr auto MaxPosition = 2.f;
+constexpr auto MinVelocity = -.008f;
+constexpr auto MaxVelocity = .008f;
+
+namespace {
+	class BitWriter final {
+	public:
+		BitWriter(std::vector<uint8_t>& target) : bytes(target) { bytes.clear(); }
+
+		void write(uint32_t value, int bits) {
+			for (auto i = bits - 1; i >= 0; i--) {
+				if (position % 8 == 0) {
+					bytes.push_back(0);
+				}
+				bytes.back() |= ((value >> i) & 1) << (7 - position % 8);
+				position++;
+			}
+		}
+	private:
+		std::vector<uint8_t>& bytes;
+		size_t                position = 0;
+	};
+
+	class BitReader final {
+	public:
+		BitReader(const std::vector<uint8_t>& source) : bytes(source) {}
+
+		auto read(int bits) -> uint32_t {
+			auto value = 0u;
+			for (auto i = 0; i < bits; i++) {
+				if (position / 8 >= bytes.size()) {
+					overflow = true;
+					return 0;
+				}
+				value = (value << 1) | ((bytes[position / 8] >> (7 - position % 8)) & 1);
+				position++;
+			}
+			return value;
+		}
+
+		auto hasOverflown() const -> bool { return overflow; }
+	private:
+		const std::vector<uint8_t>& bytes;
+		size_t                      position = 0;
+		bool                        overflow = false;
+	};
+
+	auto quantize(Scalar value, float min, float max, int bits) -> uint32_t {
+		const auto steps = static_cast<float>((1u << bits) - 1);
+		const auto normalized = std::clamp((static_cast<float>(value) - min) / (max - min), 0.f, 1.f);
+		return static_cast<uint32_t>(std::lround(normalized * steps));
+	}
+
+	auto dequantize(uint32_t value, float min, float max, int bits) -> Scalar {
+		const auto steps = static_cast<float>((1u << bits) - 1);
+		return Scalar(min + value / steps * (max - min));
+	}
+}
+
+auto Spectator::quantize(const MatchState& state) -> QuantizedState {
+	auto result = QuantizedState{};
+	result[KIND] = static_cast<uint32_t>(state.kind);
+	result[PLAYER1_SCORE] = static_cast<uint32_t>(state.player1Score);
+	result[PLAYER2_SCORE] = static_cast<uint32_t>(state.player2Score);
+	result[BALL_X] = ::quantize(state.ballPosition.x, MinPosition, MaxPosition, FieldBits[BALL_X]);
+	result[BALL_Y] = ::quantize(state.ballPosition.y, MinPosition, MaxPosition, FieldBits[BALL_Y]);
+	result[BALL_VX] = ::quantize(state.ballVelocity.x, MinVelocity, MaxVelocity, FieldBits[BALL_VX]);
+	result[BALL_VY] = ::quantize(state.ballVelocity.y, MinVelocity, MaxVelocity, FieldBits[BALL_VY]);
+	result[LEFT_PADDLE_Y] = ::quantize(state.leftPaddlePosition.y, MinPosition, MaxPosition, FieldBits[LEFT_PADDLE_Y]);
+	result[LEFT_PADDLE_VY] = ::quantize(state.leftPaddleVelocity.y, MinVelocity, MaxVelocity, FieldBits[LEFT_PADDLE_VY]);
+	result[RIGHT_PADDLE_Y] = ::quantize(state.rightPaddlePosition.y, MinPosition, MaxPosition, FieldBits[RIGHT_PADDLE_Y]);
+	result[RIGHT_PADDLE_VY] = ::quantize(state.rightPaddleVelocity.y, MinVelocity, MaxVelocity, FieldBits[RIGHT_PADDLE_VY]);
+	return result;
+}
+
+auto Spectator::dequantize(const QuantizedState& state) -> MatchState {
+	// Paddles only move vertically so their horizontal positions are constants.
+	constexpr auto LeftPaddleX = .05f;
+	constexpr auto RightPaddleX = .95f;
+
+	auto result = MatchState{};
+	result.kind = static_cast<MatchState::Kind>(state[KIND]);
+	result.player1Score = static_cast<int>(state[PLAYER1_SCORE]);
+	result.player2Score = static_cast<int>(state[PLAYER2_SCORE]);
+	result.ballPosition.x = ::dequantize(state[BALL_X], MinPosition, MaxPosition, FieldBits[BALL_X]);
+	result.ballPosition.y = ::dequantize(state[BALL_Y], MinPosition, MaxPosition, FieldBits[BALL_Y]);
+	result.ballVelocity.x = ::dequantize(state[BALL_VX], MinVelocity, MaxVelocity, FieldBits[BALL_VX]);
+	result.ballVelocity.y = ::dequantize(state[BALL_VY], MinVelocity, MaxVelocity, FieldBits[BALL_VY]);
+	result.leftPaddlePosition = { LeftPaddleX, ::dequantize(state[LEFT_PADDLE_Y], MinPosition, MaxPosition, FieldBits[LEFT_PADDLE_Y]) };
+	result.leftPaddleVelocity.y = ::dequantize(state[LEFT_PADDLE_VY], MinVelocity, MaxVelocity, FieldBits[LEFT_PADDLE_VY]);
+	result.rightPaddlePosition = { RightPaddleX, ::dequantize(state[RIGHT_PADDLE_Y], MinPosition, MaxPosition, FieldBits[RIGHT_PADDLE_Y]) };
+	result.rightPaddleVelocity.y = ::dequantize(state[RIGHT_PADDLE_VY], MinVelocity, MaxVelocity, FieldBits[RIGHT_PADDLE_VY]);
+	return result;
+}
+
+void Encoder::acknowledge(uint32_t ackedSequence) {
+	// Ignore acknowledgements that are older than the one we already have or of packets that were never sent. The
+	// sequences of the sent packets start from one.
+	if (ackedSequence > 0 && ackedSequence <= sequence && (!hasAcknowledged || ackedSequence > acknowledged)) {
+		acknowledged = ackedSequence;
+		hasAcknowledged = true;
+	}
+}
+
+void Encoder::encode(const QuantizedState& state, std::vector<uint8_t>& packet) {
+	sequence++;
+
+	// Use the acknowledged snapshot as the baseline whether it is still in the history or send a full snapshot.
+	static const auto EmptyState = QuantizedState{};
+	const auto isFull = !hasAcknowledged || sequence - acknowledged >= HistorySize;
+	const auto& baselineState = isFull ? EmptyState : history[acknowledged % HistorySize];
+	if (isFull) {
+		fullSnapshots++;
+	}
+
+	// Write the header along with the mask of the changed fields and the values of them.
+	auto writer = BitWriter{ packet };
+	writer.write(isFull ? 1 : 0, 1);
+	if (isFull) {
+		writer.write(sequence, 32);
+	} else {
+		writer.write(sequence & 0xffff, 16);
+		writer.write(acknowledged & 0xffff, 16);
+	}
+	for (auto i = 0; i < FIELD_COUNT; i++) {
+		writer.write(state[i] != baselineState[i] ? 1 : 0, 1);
+	}
+	for (auto i = 0; i < FIELD_COUNT; i++) {
+		if (state[i] != baselineState[i]) {
+			writer.write(state[i], FieldBits[i]);
+		}
+	}
+	history[sequence % HistorySize] = state;
+}
+
+auto Decoder::decode(const std::vector<uint8_t>& packet) -> bool {
+	auto reader = BitReader{ packet };
+	const auto isFull = reader.read(1) != 0;
+
+	// Extend the sequence of a delta to the closest 32-bit sequence to the latest one. Baselines precede their packet.
+	auto packetSequence = 0u;
+	auto state = QuantizedState{};
+	if (isFull) {
+		packetSequence = reader.read(32);
+	} else {
+		const auto wireSequence = static_cast<uint16_t>(reader.read(16));
+		const auto wireBaseline = static_cast<uint16_t>(reader.read(16));
+		packetSequence = sequence + static_cast<int16_t>(wireSequence - static_cast<uint16_t>(sequence));
+		const auto baseline = packetSequence - static_cast<uint16_t>(wireSequence - wireBaseline);
+
+		// Packets can only be applied when the baseline they were encoded against is still known.
+		if (slots[baseline % HistorySize] != baseline + uint64_t(1)) {
+			return false;
+		}
+		state = history[baseline % HistorySize];
+	}
+
+	// Read the mask of the changed fields and overwrite them in the baseline state.
+	auto mask = std::array<bool, FIELD_COUNT>{};
+	for (auto i = 0; i < FIELD_COUNT; i++) {
+		mask[i] = reader.read(1) != 0;
+	}
+	for (auto i = 0; i < FIELD_COUNT; i++) {
+		if (mask[i]) {
+			state[i] = reader.read(FieldBits[i]);
+		}
+	}
+	if (reader.hasOverflown()) {
+		return false;
+	}
+
+	// Packets that arrive out of order are kept as baselines but never replace a newer state.
+	if (hasDecoded && packetSequence + HistorySize <= sequence) {
+		return false;
+	}
+	history[packetSequence % HistorySize] = state;
+	slots[packetSequence % HistorySize] = packetSequence + uint64_t(1);
+	if (!hasDecoded || packetSequence > sequence) {
+		sequence = packetSequence;
+		hasDecoded = true;
+	}
+	return true;
+}
+
+void MemoryTransport::send(const std::vector<uint8_t>& packet) {
+	packets.push_back(packet);
+	sentBytes += packet.size();
+	sentPackets++;
+}
+
+auto MemoryTransport::receive(std::vector<uint8_t>& packet) -> bool {
+	if (packets.empty()) {
+		return false;
+	}
+	packet = std::move(packets.front());
+	packets.pop_front();
+	return true;
+}
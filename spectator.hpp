@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "matchstate.hpp"
+
+// The spectator stream sends quantized match states where each packet contains only the fields that have changed
+// since the last snapshot the spectator has acknowledged. A packet is laid out as a bit-packed sequence of
+//
+//   full snapshot (1 bit) | sequence | [baseline sequence (16 bits)] | changed field mask | changed fields
+//
+// where a full snapshot is a delta against an all-zero state that has no baseline. Both ends track the sequences in 32
+// bits. Full snapshots carry the whole sequence so a decoder can always resynchronize, while deltas carry only the low
+// 16 bits of the sequence and of the baseline, which is always within the history of the sequence.
+namespace Spectator {
+	enum Field { KIND, PLAYER1_SCORE, PLAYER2_SCORE, BALL_X, BALL_Y, BALL_VX, BALL_VY, LEFT_PADDLE_Y, LEFT_PADDLE_VY,
+		RIGHT_PADDLE_Y, RIGHT_PADDLE_VY, FIELD_COUNT };
+
+	// QuantizedState is a match state where each field has been quantized into an unsigned integer.
+	using QuantizedState = std::array<uint32_t, FIELD_COUNT>;
+
+	auto quantize(const MatchState& state) -> QuantizedState;
+	auto dequantize(const QuantizedState& state) -> MatchState;
+
+	// Encoder produces the delta packets for a single spectator.
+	class Encoder final {
+	public:
+		void acknowledge(uint32_t sequence);
+		void encode(const QuantizedState& state, std::vector<uint8_t>& packet);
+		auto getFullSnapshots() const -> uint64_t { return fullSnapshots; }
+	private:
+		static constexpr auto HistorySize = 64;
+
+		std::array<QuantizedState, HistorySize> history = {};
+		uint32_t                                sequence = 0;
+		uint32_t                                acknowledged = 0;
+		bool                                    hasAcknowledged = false;
+		uint64_t                                fullSnapshots = 0;
+	};
+
+	// Decoder rebuilds match states from the delta packets of a single stream.
+	class Decoder final {
+	public:
+		auto decode(const std::vector<uint8_t>& packet) -> bool;
+		auto getSequence() const -> uint32_t { return sequence; }
+		auto getState() const -> MatchState { return dequantize(history[sequence % HistorySize]); }
+	private:
+		static constexpr auto HistorySize = 64;
+
+		std::array<QuantizedState, HistorySize> history = {};
+		std::array<uint64_t, HistorySize>       slots = {}; // the sequence + 1 of each stored state, zero if empty
+		uint32_t                                sequence = 0;
+		bool                                    hasDecoded = false;
+	};
+
+	// MemoryTransport is a lossless in-memory packet channel that counts the amount of transferred bytes.
+	class MemoryTransport final {
+	public:
+		void send(const std::vector<uint8_t>& packet);
+		auto receive(std::vector<uint8_t>& packet) -> bool;
+		auto getSentBytes() const -> uint64_t { return sentBytes; }
+		auto getSentPackets() const -> uint64_t { return sentPackets; }
+	private:
+		std::deque<std::vector<uint8_t>> packets;
+		uint64_t                         sentBytes = 0;
+		uint64_t                         sentPackets = 0;
+	};
+}
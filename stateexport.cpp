@@ -0,0 +1,108 @@
+#include "stateexport.hpp"
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace StateExport;
+
+auto StateExport::toSnapshot(const MatchState& state) -> Snapshot {
+	auto snapshot = Snapshot{};
+	snapshot.kind = static_cast<uint32_t>(state.kind);
+	snapshot.player1Score = state.player1Score;
+	snapshot.player2Score = state.player2Score;
+	snapshot.ballPosition[0] = static_cast<float>(state.ballPosition.x);
+	snapshot.ballPosition[1] = static_cast<float>(state.ballPosition.y);
+	snapshot.ballVelocity[0] = static_cast<float>(state.ballVelocity.x);
+	snapshot.ballVelocity[1] = static_cast<float>(state.ballVelocity.y);
+	snapshot.leftPaddlePosition[0] = static_cast<float>(state.leftPaddlePosition.x);
+	snapshot.leftPaddlePosition[1] = static_cast<float>(state.leftPaddlePosition.y);
+	snapshot.leftPaddleVelocity[0] = static_cast<float>(state.leftPaddleVelocity.x);
+	snapshot.leftPaddleVelocity[1] = static_cast<float>(state.leftPaddleVelocity.y);
+	snapshot.rightPaddlePosition[0] = static_cast<float>(state.rightPaddlePosition.x);
+	snapshot.rightPaddlePosition[1] = static_cast<float>(state.rightPaddlePosition.y);
+	snapshot.rightPaddleVelocity[0] = static_cast<float>(state.rightPaddleVelocity.x);
+	snapshot.rightPaddleVelocity[1] = static_cast<float>(state.rightPaddleVelocity.y);
+	return snapshot;
+}
+
+void StateExport::write(Segment& segment, const Snapshot& snapshot) {
+	// Mark the snapshot as being written before touching it.
+	const auto sequence = segment.sequence.load(std::memory_order_relaxed);
+	segment.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	segment.snapshot = snapshot;
+
+	// Mark the snapshot as complete.
+	segment.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+auto StateExport::read(const Segment& segment, Snapshot& snapshot) -> bool {
+	constexpr auto MaxAttempts = 64;
+	for (auto attempt = 0; attempt < MaxAttempts; attempt++) {
+		const auto before = segment.sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			continue;
+		}
+		snapshot = segment.snapshot;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (segment.sequence.load(std::memory_order_relaxed) == before) {
+			return true;
+		}
+	}
+	return false;
+}
+
+Writer::Writer(Name name) {
+	#if defined(_WIN32)
+	mapping = CreateFileMappingFromApp(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, sizeof(Segment), name);
+	if (mapping) {
+		segment = static_cast<Segment*>(MapViewOfFileFromApp(mapping, FILE_MAP_WRITE, 0, sizeof(Segment)));
+	}
+	#else
+	const auto descriptor = shm_open(name, O_CREAT | O_RDWR, 0644);
+	if (descriptor >= 0) {
+		this->name = name;
+		if (ftruncate(descriptor, sizeof(Segment)) == 0) {
+			auto view = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+			segment = view != MAP_FAILED ? static_cast<Segment*>(view) : nullptr;
+		}
+		close(descriptor);
+	}
+	#endif
+	if (segment) {
+		segment->magic = Magic;
+		segment->version = Version;
+		segment->sequence.store(0, std::memory_order_release);
+	}
+}
+
+Writer::~Writer() {
+	#if defined(_WIN32)
+	if (segment) {
+		UnmapViewOfFile(segment);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+	#else
+	if (segment) {
+		munmap(segment, sizeof(Segment));
+		shm_unlink(name.c_str());
+	}
+	#endif
+}
+
+void Writer::publish(const MatchState& state) {
+	if (segment) {
+		write(*segment, toSnapshot(state));
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "matchstate.hpp"
+
+// The state export publishes the live match state into a named shared memory segment for local tools.
+//
+// The segment is guarded by a sequence lock: the writer makes the sequence odd while it updates the snapshot and even
+// again when it is done. Readers copy the snapshot and retry whether the sequence was odd or changed meanwhile, so
+// the game never waits for a reader.
+//
+// On Windows the game runs in an app container, which places its named objects into the private namespace
+// AppContainerNamedObjects\<package SID>\ of the session. Tools outside of the package have to open the segment by its
+// full path, which the reader derives from the package family name of the game.
+namespace StateExport {
+	#if defined(_WIN32)
+	using Name = const wchar_t*;
+	constexpr auto SegmentName = L"uwp-pong-state";
+	#else
+	using Name = const char*;
+	constexpr auto SegmentName = "/uwp-pong-state";
+	#endif
+	constexpr auto Magic = 0x504f4e47u; // "PONG"
+	constexpr auto Version = 1u;
+
+	// Snapshot is a plain copy of the match state with floating point values.
+	struct Snapshot {
+		uint32_t kind;
+		int32_t  player1Score;
+		int32_t  player2Score;
+		float    ballPosition[2];
+		float    ballVelocity[2];
+		float    leftPaddlePosition[2];
+		float    leftPaddleVelocity[2];
+		float    rightPaddlePosition[2];
+		float    rightPaddleVelocity[2];
+	};
+
+	// Segment is the layout of the shared memory segment.
+	struct Segment {
+		uint32_t              magic;
+		uint32_t              version;
+		std::atomic<uint32_t> sequence;
+		Snapshot              snapshot;
+	};
+
+	auto toSnapshot(const MatchState& state) -> Snapshot;
+
+	// Writes and reads a snapshot of a segment with the sequence lock.
+	void write(Segment& segment, const Snapshot& snapshot);
+	auto read(const Segment& segment, Snapshot& snapshot) -> bool;
+
+	// Writer creates the segment and publishes snapshots into it. Publishing does nothing when the segment could not be
+	// created, as the export is not needed to play.
+	class Writer final {
+	public:
+		explicit Writer(Name name = SegmentName);
+		~Writer();
+		Writer(const Writer&) = delete;
+		auto operator=(const Writer&) -> Writer& = delete;
+
+		auto isOpen() const -> bool { return segment != nullptr; }
+		void publish(const MatchState& state);
+	private:
+		void*    mapping = nullptr;
+		Segment* segment = nullptr;
+		#if !defined(_WIN32)
+		std::string name;
+		#endif
+	};
+
+	// Reader opens an existing segment and reads consistent snapshots from it without any copies of the segment.
+	class Reader final {
+	public:
+		// Opens the segment of a game in the namespace of the caller.
+		explicit Reader(Name name = SegmentName);
+		#if defined(_WIN32)
+		// Opens the segment of the game package with the given family name from a process outside of the package.
+		Reader(const wchar_t* packageFamilyName, Name name);
+		#endif
+		~Reader();
+		Reader(const Reader&) = delete;
+		auto operator=(const Reader&) -> Reader& = delete;
+
+		auto isOpen() const -> bool { return segment != nullptr; }
+		auto read(Snapshot& snapshot) const -> bool { return StateExport::read(*segment, snapshot); }
+	private:
+		void*          mapping = nullptr;
+		const Segment* segment = nullptr;
+	};
+}
@@ -0,0 +1,91 @@
+#include "stateexport.hpp"
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <userenv.h>
+#include <string>
+
+#pragma comment(lib, "userenv.lib")
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// The reader is a library for tools that run outside of the game. It doesn't use WinRT or the game itself and isn't
+// part of the game package.
+using namespace StateExport;
+
+namespace {
+	#if defined(_WIN32)
+	auto open(const wchar_t* name, void*& mapping) -> const Segment* {
+		mapping = OpenFileMappingW(FILE_MAP_READ, false, name);
+		if (!mapping) {
+			return nullptr;
+		}
+		return static_cast<const Segment*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(Segment)));
+	}
+	#endif
+
+	// Only accept segments of the layout this reader was built for.
+	auto validate(const Segment* segment) -> const Segment* {
+		if (segment && (segment->magic != Magic || segment->version != Version)) {
+			#if defined(_WIN32)
+			UnmapViewOfFile(segment);
+			#else
+			munmap(const_cast<Segment*>(segment), sizeof(Segment));
+			#endif
+			return nullptr;
+		}
+		return segment;
+	}
+}
+
+Reader::Reader(Name name) {
+	#if defined(_WIN32)
+	segment = validate(open(name, mapping));
+	#else
+	const auto descriptor = shm_open(name, O_RDONLY, 0);
+	if (descriptor >= 0) {
+		auto view = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, descriptor, 0);
+		segment = validate(view != MAP_FAILED ? static_cast<const Segment*>(view) : nullptr);
+		close(descriptor);
+	}
+	#endif
+}
+
+#if defined(_WIN32)
+Reader::Reader(const wchar_t* packageFamilyName, Name name) {
+	// Named objects of a package live in the namespace of its app container, which is named by the package SID.
+	PSID sid = nullptr;
+	if (FAILED(DeriveAppContainerSidFromAppContainerName(packageFamilyName, &sid))) {
+		return;
+	}
+	wchar_t path[MAX_PATH] = {};
+	auto length = ULONG{ 0 };
+	const auto found = GetAppContainerNamedObjectPath(nullptr, sid, MAX_PATH, path, &length);
+	FreeSid(sid);
+	if (found) {
+		const auto fullName = std::wstring(path) + L"\\" + std::wstring(name);
+		segment = validate(open(fullName.c_str(), mapping));
+	}
+}
+#endif
+
+Reader::~Reader() {
+	#if defined(_WIN32)
+	if (segment) {
+		UnmapViewOfFile(segment);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+	}
+	#else
+	if (segment) {
+		munmap(const_cast<Segment*>(segment), sizeof(Segment));
+	}
+	#endif
+}
@@ -0,0 +1,171 @@
+#include "taskgraph.hpp"
+
+#include <cstdio>
+
+TaskGraph::TaskGraph(Executor taskExecutor) : executor(std::move(taskExecutor)) {
+}
+
+TaskGraph::~TaskGraph() {
+	waitAll();
+}
+
+auto TaskGraph::add(std::string name, std::function<void()> work, std::vector<TaskId> dependencies) -> TaskId {
+	const auto id = tasks.size();
+	auto task = Task{};
+	task.name = std::move(name);
+	task.work = std::move(work);
+	task.pendingDependencies = dependencies.size();
+	tasks.push_back(std::move(task));
+	for (auto dependency : dependencies) {
+		tasks[dependency].dependents.push_back(id);
+	}
+	return id;
+}
+
+void TaskGraph::start() {
+	auto ready = std::vector<TaskId>{};
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		startTime = Clock::now();
+		remainingTasks = tasks.size();
+		for (auto id = TaskId{ 0 }; id < tasks.size(); id++) {
+			if (tasks[id].pendingDependencies == 0) {
+				ready.push_back(id);
+			}
+		}
+	}
+	for (auto task : ready) {
+		submit(task);
+	}
+}
+
+void TaskGraph::submit(TaskId task) {
+	// Tasks are submitted outside of the lock as an executor may run them right away.
+	if (executor) {
+		executor([this, task] { execute(task); });
+	} else {
+		std::lock_guard<std::mutex> lock{ mutex };
+		threads.emplace_back(&TaskGraph::execute, this, task);
+	}
+}
+
+void TaskGraph::execute(TaskId id) {
+	auto& task = tasks[id];
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		task.start = Clock::now();
+	}
+	auto error = std::exception_ptr{};
+	try {
+		task.work();
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	// Start the dependents that were only waiting for this task, or fail them along with it.
+	auto ready = std::vector<TaskId>{};
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+		if (error) {
+			fail(id, error);
+		} else {
+			task.end = Clock::now();
+			task.done = true;
+			remainingTasks--;
+			for (auto dependent : task.dependents) {
+				if (--tasks[dependent].pendingDependencies == 0) {
+					ready.push_back(dependent);
+				}
+			}
+		}
+
+		// Notify under the lock as the graph may be destroyed as soon as the last task is done.
+		condition.notify_all();
+	}
+	for (auto dependent : ready) {
+		submit(dependent);
+	}
+}
+
+void TaskGraph::fail(TaskId id, std::exception_ptr error) {
+	auto& task = tasks[id];
+	if (task.done) {
+		return;
+	}
+	if (task.start == Clock::time_point{}) {
+		task.start = Clock::now();
+	}
+	task.end = Clock::now();
+	task.done = true;
+	task.error = error;
+	remainingTasks--;
+	for (auto dependent : task.dependents) {
+		fail(dependent, error);
+	}
+}
+
+void TaskGraph::wait(TaskId id) {
+	std::unique_lock<std::mutex> lock{ mutex };
+	condition.wait(lock, [this, id] { return tasks[id].done; });
+	if (tasks[id].error) {
+		std::rethrow_exception(tasks[id].error);
+	}
+}
+
+void TaskGraph::waitAll() {
+	{
+		std::unique_lock<std::mutex> lock{ mutex };
+		condition.wait(lock, [this] { return remainingTasks == 0; });
+	}
+
+	// No more threads are started once every task is done.
+	for (auto& thread : threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+}
+
+void TaskGraph::mark(std::string name) {
+	std::lock_guard<std::mutex> lock{ mutex };
+	const auto time = Clock::now() - startTime;
+	milestones.push_back({ std::move(name), Timing::Status::MILESTONE, time, time });
+}
+
+auto TaskGraph::getTimings() const -> std::vector<Timing> {
+	std::lock_guard<std::mutex> lock{ mutex };
+	auto timings = std::vector<Timing>{};
+	for (const auto& task : tasks) {
+		auto timing = Timing{ task.name };
+		if (task.done) {
+			timing.status = task.error ? Timing::Status::FAILED : Timing::Status::COMPLETED;
+			timing.start = task.start - startTime;
+			timing.end = task.end - startTime;
+		}
+		timings.push_back(timing);
+	}
+	timings.insert(timings.end(), milestones.begin(), milestones.end());
+	return timings;
+}
+
+auto TaskGraph::formatReport() const -> std::string {
+	const auto toMS = [](Clock::duration duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+	auto report = std::string{};
+	for (const auto& timing : getTimings()) {
+		char line[128];
+		switch (timing.status) {
+		case Timing::Status::PENDING:
+			std::snprintf(line, sizeof(line), "%-12s pending\n", timing.name.c_str());
+			break;
+		case Timing::Status::MILESTONE:
+			std::snprintf(line, sizeof(line), "%-12s at %9.3fms\n", timing.name.c_str(), toMS(timing.end));
+			break;
+		default:
+			std::snprintf(line, sizeof(line), "%-12s %9.3fms .. %9.3fms %9.3fms%s\n", timing.name.c_str(), toMS(timing.start),
+				toMS(timing.end), toMS(timing.end - timing.start), timing.status == Timing::Status::FAILED ? " failed" : "");
+			break;
+		}
+		report += line;
+	}
+	return report;
+}
\ No newline at end of file
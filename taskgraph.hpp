@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// TaskGraph runs a set of tasks in parallel where each task starts as soon as the tasks it depends on have completed.
+//
+// Tasks are handed to an executor, or run on threads of their own when no executor is given, and never block a thread
+// while they wait for their dependencies. A task that throws fails its dependents without running them and the
+// exception is rethrown to whoever waits for them. The graph times each task so that it can report where the time of
+// e.g. the startup went.
+class TaskGraph final {
+public:
+	using Clock = std::chrono::steady_clock;
+	using TaskId = size_t;
+	using Executor = std::function<void(std::function<void()>)>;
+
+	// Timing tells when a task started and ended relative to the start of the graph. Milestones have no duration.
+	struct Timing {
+		enum class Status { PENDING, COMPLETED, FAILED, MILESTONE };
+
+		std::string     name;
+		Status          status = Status::PENDING;
+		Clock::duration start = {};
+		Clock::duration end = {};
+	};
+
+	TaskGraph(Executor executor = {});
+	~TaskGraph();
+	TaskGraph(const TaskGraph&) = delete;
+	auto operator=(const TaskGraph&) -> TaskGraph& = delete;
+
+	// Tasks can only be added before the graph is started.
+	auto add(std::string name, std::function<void()> work, std::vector<TaskId> dependencies = {}) -> TaskId;
+	void start();
+	void wait(TaskId task);
+	void waitAll();
+
+	void mark(std::string name);
+	auto getTimings() const -> std::vector<Timing>;
+	auto formatReport() const -> std::string;
+private:
+	struct Task {
+		std::string           name;
+		std::function<void()> work;
+		std::vector<TaskId>   dependents;
+		size_t                pendingDependencies = 0;
+		bool                  done = false;
+		std::exception_ptr    error;
+		Clock::time_point     start;
+		Clock::time_point     end;
+	};
+
+	void submit(TaskId task);
+	void execute(TaskId task);
+	void fail(TaskId task, std::exception_ptr error);
+
+	Executor                 executor;
+	std::vector<Task>        tasks;
+	std::vector<Timing>      milestones;
+	std::vector<std::thread> threads;
+	Clock::time_point        startTime;
+	size_t                   remainingTasks = 0;
+	mutable std::mutex       mutex;
+	std::condition_variable  condition;
+};
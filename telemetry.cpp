@@ -0,0 +1,214 @@
+#include "telemetry.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Telemetry;
+
+constexpr auto Magic = 0x4c455450u; // "PTEL"
+constexpr auto Version = 2u; // version 1 had no sessions, which read as zero
+
+namespace {
+	// Ring is a single-producer single-consumer event queue owned by a single recording thread.
+	struct Ring {
+		static constexpr auto Capacity = 4096u;
+
+		std::array<Event, Capacity> events;
+		std::atomic<uint32_t>       head = 0; // written by the recording thread
+		std::atomic<uint32_t>       tail = 0; // written by the flusher thread
+	};
+
+	struct Log {
+		std::mutex                         mutex;
+		std::condition_variable            condition;
+		std::vector<std::unique_ptr<Ring>> rings;
+		std::ofstream                      file;
+		std::thread                        flusher;
+		bool                               running = false;
+		std::atomic<uint32_t>              session = 0;
+		std::atomic<uint64_t>              recorded = 0;
+		std::atomic<uint64_t>              dropped = 0;
+		std::atomic<uint64_t>              flushed = 0;
+	};
+
+	Log eventLog;
+	thread_local Ring* threadRing = nullptr;
+
+	// Move all pending events from the rings into the log file.
+	void flush() {
+		std::vector<Ring*> rings;
+		{
+			std::lock_guard<std::mutex> lock{ eventLog.mutex };
+			for (const auto& ring : eventLog.rings) {
+				rings.push_back(ring.get());
+			}
+		}
+		for (auto ring : rings) {
+			const auto head = ring->head.load(std::memory_order_acquire);
+			auto tail = ring->tail.load(std::memory_order_relaxed);
+			for (; tail != head; tail++) {
+				eventLog.file.write(reinterpret_cast<const char*>(&ring->events[tail % Ring::Capacity]), sizeof(Event));
+				eventLog.flushed++;
+			}
+			ring->tail.store(tail, std::memory_order_release);
+		}
+	}
+
+	void runFlusher() {
+		constexpr auto FlushInterval = std::chrono::milliseconds(50);
+		auto lock = std::unique_lock<std::mutex>{ eventLog.mutex };
+		while (eventLog.running) {
+			eventLog.condition.wait_for(lock, FlushInterval);
+			lock.unlock();
+			flush();
+			lock.lock();
+		}
+	}
+}
+
+void Telemetry::start(const std::filesystem::path& filename) {
+	std::lock_guard<std::mutex> lock{ eventLog.mutex };
+	if (eventLog.running) {
+		return;
+	}
+
+	// Appending streams report a zero position until the first write, so the size of the file tells whether the log is
+	// new and needs a header.
+	auto error = std::error_code{};
+	const auto isNew = !std::filesystem::exists(filename, error) || std::filesystem::file_size(filename, error) == 0;
+	eventLog.session = std::random_device{}() ^ static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
+	eventLog.file.open(filename, std::ios::binary | std::ios::app);
+	if (isNew) {
+		const uint32_t header[] = { Magic, Version };
+		eventLog.file.write(reinterpret_cast<const char*>(header), sizeof(header));
+	}
+	eventLog.running = true;
+	eventLog.flusher = std::thread(runFlusher);
+}
+
+void Telemetry::stop() {
+	{
+		std::lock_guard<std::mutex> lock{ eventLog.mutex };
+		if (!eventLog.running) {
+			return;
+		}
+		eventLog.running = false;
+	}
+	eventLog.condition.notify_one();
+	eventLog.flusher.join();
+	flush();
+	eventLog.file.close();
+}
+
+void Telemetry::registerThread() {
+	if (!threadRing) {
+		auto ring = std::make_unique<Ring>();
+		threadRing = ring.get();
+		std::lock_guard<std::mutex> lock{ eventLog.mutex };
+		eventLog.rings.push_back(std::move(ring));
+	}
+}
+
+void Telemetry::record(EventType type, uint32_t match, uint8_t subject, float x, float y, float speed) {
+	registerThread();
+	const auto head = threadRing->head.load(std::memory_order_relaxed);
+	if (head - threadRing->tail.load(std::memory_order_acquire) >= Ring::Capacity) {
+		eventLog.dropped++;
+		return;
+	}
+	auto& event = threadRing->events[head % Ring::Capacity];
+	event.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+	event.match = match;
+	event.type = type;
+	event.subject = subject;
+	event.reserved = 0;
+	event.x = x;
+	event.y = y;
+	event.speed = speed;
+	event.session = eventLog.session.load(std::memory_order_relaxed);
+	threadRing->head.store(head + 1, std::memory_order_release);
+	eventLog.recorded++;
+}
+
+auto Telemetry::getStatistics() -> Statistics {
+	auto stats = Statistics{};
+	stats.recorded = eventLog.recorded;
+	stats.dropped = eventLog.dropped;
+	stats.flushed = eventLog.flushed;
+	return stats;
+}
+
+auto Telemetry::aggregate(const std::filesystem::path& filename, Summary& summary,
+	const std::function<void(const MatchSummary&)>& onMatch) -> bool {
+	std::ifstream file(filename, std::ios::binary);
+	uint32_t header[2] = {};
+	if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != Magic || header[1] < 1 || header[1] > Version) {
+		return false;
+	}
+
+	// Each launch appends its events after those of the previous one and only the game thread records them, so the
+	// events of a session and of a match are contiguous in the log. Counting the runs of ids keeps the aggregation
+	// free of lookups however many matches the log has. The start screens belong to no match.
+	auto current = MatchSummary{};
+	const auto finishMatch = [&summary, &onMatch, &current] {
+		if (current.events > 0 && current.match != 0) {
+			summary.matches++;
+			if (onMatch) {
+				onMatch(current);
+			}
+		}
+	};
+
+	// Read the log in large blocks to keep the aggregation bound by the disk throughput.
+	constexpr auto BlockEvents = 64 * 1024;
+	auto events = std::vector<Event>(BlockEvents);
+	while (file) {
+		file.read(reinterpret_cast<char*>(events.data()), BlockEvents * sizeof(Event));
+		const auto count = static_cast<size_t>(file.gcount()) / sizeof(Event);
+		for (auto i = 0u; i < count; i++) {
+			const auto& event = events[i];
+			const auto side = event.subject & 1;
+			const auto newSession = summary.events == 0 || event.session != current.session;
+			if (newSession || event.match != current.match) {
+				finishMatch();
+				summary.sessions += newSession;
+				current = MatchSummary{};
+				current.session = event.session;
+				current.match = event.match;
+				current.startTimestamp = event.timestamp;
+			}
+			summary.events++;
+			current.events++;
+			current.endTimestamp = event.timestamp;
+			switch (event.type) {
+			case EventType::PADDLE_HIT:
+				summary.paddleHits[side]++;
+				summary.totalPaddleHitSpeed += event.speed;
+				summary.maxPaddleHitSpeed = std::max(summary.maxPaddleHitSpeed, event.speed);
+				current.paddleHits[side]++;
+				current.maxPaddleHitSpeed = std::max(current.maxPaddleHitSpeed, event.speed);
+				break;
+			case EventType::WALL_BOUNCE:
+				summary.wallBounces[side]++;
+				current.wallBounces[side]++;
+				break;
+			case EventType::GOAL:
+				summary.goals[side]++;
+				current.goals[side]++;
+				break;
+			case EventType::STATE_CHANGE:
+				break;
+			}
+		}
+	}
+	finishMatch();
+	return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+
+// Telemetry records gameplay events into a binary event log.
+//
+// Each thread writes its events into its own lock-free ring buffer and a background thread flushes the buffers into
+// the log file. Recording never waits: events are dropped and counted when a ring is full. Define PONG_NO_TELEMETRY
+// to compile the recording of the game out.
+//
+// Each launch of the game appends its events into the same log under a random session id, as the match numbers start
+// over with each launch. Events of the start screen that precedes the first match have the match number zero.
+namespace Telemetry {
+	enum class EventType : uint8_t { PADDLE_HIT, WALL_BOUNCE, GOAL, STATE_CHANGE };
+
+	// Event is a single fixed-size log record.
+	struct Event {
+		uint64_t  timestamp; // nanoseconds from the steady clock
+		uint32_t  match;
+		EventType type;
+		uint8_t   subject;   // the paddle, wall, goal or state the event concerns
+		uint16_t  reserved;
+		float     x;
+		float     y;
+		float     speed;
+		uint32_t  session;
+	};
+	static_assert(sizeof(Event) == 32, "telemetry events must have a stable layout");
+
+	struct Statistics {
+		uint64_t recorded = 0;
+		uint64_t dropped = 0;
+		uint64_t flushed = 0;
+	};
+
+	void start(const std::filesystem::path& filename);
+	void stop();
+	void registerThread();
+	void record(EventType type, uint32_t match, uint8_t subject, float x, float y, float speed);
+	auto getStatistics() -> Statistics;
+
+	// Summary contains aggregated values of one or more event logs.
+	struct Summary {
+		uint64_t events = 0;
+		uint64_t sessions = 0;
+		uint64_t matches = 0;
+		uint64_t paddleHits[2] = {};
+		uint64_t wallBounces[2] = {};
+		uint64_t goals[2] = {};
+		double   totalPaddleHitSpeed = 0.0;
+		float    maxPaddleHitSpeed = 0.f;
+	};
+
+	// MatchSummary contains aggregated values of the events of a single match.
+	struct MatchSummary {
+		uint32_t session = 0;
+		uint32_t match = 0;
+		uint64_t events = 0;
+		uint64_t paddleHits[2] = {};
+		uint64_t wallBounces[2] = {};
+		uint64_t goals[2] = {};
+		float    maxPaddleHitSpeed = 0.f;
+		uint64_t startTimestamp = 0;
+		uint64_t endTimestamp = 0;
+	};
+
+	// Aggregates the events of a log into the summary and passes each match to the optional callback once its events
+	// have been read.
+	auto aggregate(const std::filesystem::path& filename, Summary& summary,
+		const std::function<void(const MatchSummary&)>& onMatch = {}) -> bool;
+}
@@ -0,0 +1,85 @@
+#include "diagnostics.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Diagnostics::Counted;
+
+// The allocations escape through a global so that the compiler can't elide them.
+static std::unique_ptr<std::vector<int>> escaped;
+
+static void testAllocationsAreCounted() {
+	const auto before = Diagnostics::getCounters();
+	escaped = std::make_unique<std::vector<int>>(100);
+	escaped.reset();
+	const auto after = Diagnostics::getCounters();
+	CHECK(after.allocations - before.allocations == 2);
+	CHECK(after.deallocations - before.deallocations == 2);
+	CHECK(after.allocatedBytes - before.allocatedBytes >= 100 * sizeof(int));
+}
+
+static void testCopiesAreCountedAsReferenceOperations() {
+	auto pointer = Counted<std::shared_ptr<int>>{ std::make_shared<int>(1) };
+	auto before = Diagnostics::getCounters();
+
+	// A copy increments the reference count and releasing it decrements it.
+	{
+		const auto copy = pointer;
+		CHECK(pointer.use_count() == 2);
+	}
+	auto after = Diagnostics::getCounters();
+	CHECK(after.referenceOperations - before.referenceOperations == 2);
+
+	// Moves and plain references don't touch the reference count.
+	before = after;
+	auto moved = std::move(pointer);
+	const auto& reference = moved;
+	CHECK(*reference == 1);
+	pointer = std::move(moved);
+	after = Diagnostics::getCounters();
+	CHECK(after.referenceOperations == before.referenceOperations);
+
+	// Assigning a copy over another pointer releases the old one and references the new one.
+	auto other = Counted<std::shared_ptr<int>>{ std::make_shared<int>(2) };
+	before = Diagnostics::getCounters();
+	other = pointer;
+	after = Diagnostics::getCounters();
+	CHECK(after.referenceOperations - before.referenceOperations == 2);
+	CHECK(pointer.use_count() == 2);
+}
+
+static void testCountersArePerThread() {
+	auto started = std::atomic<bool>{ false };
+	auto measured = std::atomic<bool>{ false };
+	auto workerAllocations = uint64_t(0);
+	auto worker = std::thread([&] {
+		started = true;
+		while (!measured) {
+			std::this_thread::yield();
+		}
+		const auto before = Diagnostics::getCounters();
+		escaped = std::make_unique<std::vector<int>>();
+		workerAllocations = Diagnostics::getCounters().allocations - before.allocations;
+	});
+	while (!started) {
+		std::this_thread::yield();
+	}
+
+	// The allocations of the worker don't show up in the counters of this thread.
+	const auto before = Diagnostics::getCounters();
+	measured = true;
+	worker.join();
+	CHECK(Diagnostics::getCounters().allocations == before.allocations);
+	CHECK(workerAllocations == 1);
+	escaped.reset();
+}
+
+int main() {
+	testAllocationsAreCounted();
+	testCopiesAreCountedAsReferenceOperations();
+	testCountersArePerThread();
+	return EXIT_SUCCESS;
+}
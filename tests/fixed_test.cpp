@@ -0,0 +1,36 @@
+#include "fixed.hpp"
+#include "test.hpp"
+
+static void testConversionsRoundToNearest() {
+	CHECK(Fixed(.0004f).getRaw() == 6711);
+	CHECK(Fixed(-.0004f).getRaw() == -6711);
+	CHECK(Fixed(-3).getRaw() == -3 * Fixed::One);
+	CHECK(static_cast<float>(Fixed(-1.5f)) == -1.5f);
+}
+
+static void testArithmeticWithNegativeValues() {
+	CHECK(Fixed(-3) * Fixed(.5f) == Fixed(-1.5f));
+	CHECK(Fixed(-3) * Fixed(-.5f) == Fixed(1.5f));
+	CHECK(Fixed(-3) / Fixed(2) == Fixed(-1.5f));
+	CHECK(Fixed(3) / Fixed(-2) == Fixed(-1.5f));
+	CHECK(Fixed(-.75f) / Fixed(-.25f) == Fixed(3));
+
+	// Quotients are truncated towards zero like integer divisions, so the sign doesn't change their magnitude.
+	CHECK(Fixed(-1) / Fixed(3) == -(Fixed(1) / Fixed(3)));
+	CHECK(Fixed::fromRaw(-1) / Fixed(-1) == Fixed::fromRaw(1));
+}
+
+static void testSweptQuotientsStayInRange() {
+	// The swept collision test divides distances of the court by displacements as small as one raw unit.
+	const auto distance = Fixed(-1.5f);
+	const auto quotient = distance / Fixed::fromRaw(1);
+	CHECK(quotient == Fixed(-1.5f * Fixed::One));
+	CHECK(quotient > std::numeric_limits<Fixed>::lowest());
+}
+
+int main() {
+	testConversionsRoundToNearest();
+	testArithmeticWithNegativeValues();
+	testSweptQuotientsStayInRange();
+	return EXIT_SUCCESS;
+}
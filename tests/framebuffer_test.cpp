@@ -0,0 +1,91 @@
+#include "framebuffer.hpp"
+#include "test.hpp"
+
+static auto countPixels(const Framebuffer& framebuffer, uint32_t color) -> int {
+	auto count = 0;
+	for (auto y = 0; y < framebuffer.getHeight(); y++) {
+		for (auto x = 0; x < framebuffer.getWidth(); x++) {
+			count += framebuffer.getPixel(x, y) == color;
+		}
+	}
+	return count;
+}
+
+static void testRectanglesFillThePixelsOfTheirCenters() {
+	auto framebuffer = Framebuffer{ 10, 10 };
+	CHECK(countPixels(framebuffer, Framebuffer::Black) == 100);
+	framebuffer.fill(Framebuffer::White, 1.4f, 2.f, 3.6f, 4.5f);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 3 * 2);
+	CHECK(framebuffer.getPixel(1, 2) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(3, 3) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(0, 2) == Framebuffer::Black);
+	CHECK(framebuffer.getPixel(1, 4) == Framebuffer::Black);
+
+	// Adjacent rectangles share no pixels.
+	framebuffer.clear(Framebuffer::Black);
+	framebuffer.fill(0xff000001, 0.f, 0.f, 4.5f, 10.f);
+	framebuffer.fill(0xff000002, 4.5f, 0.f, 10.f, 10.f);
+	CHECK(countPixels(framebuffer, 0xff000001) == 40);
+	CHECK(countPixels(framebuffer, 0xff000002) == 60);
+}
+
+static void testRectanglesAreClippedIntoTheFramebuffer() {
+	auto framebuffer = Framebuffer{ 10, 10 };
+	framebuffer.fill(Framebuffer::White, -5.f, -5.f, 2.f, 2.f);
+	framebuffer.fill(Framebuffer::White, 9.f, 9.f, 20.f, 20.f);
+	framebuffer.fill(Framebuffer::White, 20.f, 20.f, 30.f, 30.f);
+	framebuffer.fill(Framebuffer::White, 5.f, 5.f, 4.f, 4.f);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 4 + 1);
+}
+
+static void testMasksBlendTheColorByTheirCoverage() {
+	auto framebuffer = Framebuffer{ 4, 4 };
+	framebuffer.clear(0xff204060);
+	const uint8_t mask[] = {
+		0, 255,
+		128, 0,
+	};
+	framebuffer.fillMask(0xffa0c0e0, mask, 2, 2, 2, 1, 1);
+	CHECK(framebuffer.getPixel(1, 1) == 0xff204060);
+	CHECK(framebuffer.getPixel(2, 1) == 0xffa0c0e0);
+	CHECK(framebuffer.getPixel(1, 2) == 0xff6080a0);
+	CHECK(framebuffer.getPixel(2, 2) == 0xff204060);
+	CHECK(countPixels(framebuffer, 0xff204060) == 14);
+
+	// Masks are clipped at every edge.
+	framebuffer.clear(Framebuffer::Black);
+	const uint8_t full[] = { 255, 255, 255, 255 };
+	framebuffer.fillMask(Framebuffer::White, full, 2, 2, 2, -1, -1);
+	framebuffer.fillMask(Framebuffer::White, full, 2, 2, 2, 3, 3);
+	framebuffer.fillMask(Framebuffer::White, full, 2, 2, 2, 5, -5);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 2);
+	CHECK(framebuffer.getPixel(0, 0) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(3, 3) == Framebuffer::White);
+}
+
+static void testFillsStayWithinTheClip() {
+	auto framebuffer = Framebuffer{ 10, 10 };
+	const uint8_t full[] = { 255, 255, 255, 255, 255, 255, 255, 255, 255 };
+	framebuffer.setClip(2.f, 2.f, 5.f, 5.f);
+	framebuffer.fill(Framebuffer::White, 0.f, 0.f, 10.f, 3.f);
+	framebuffer.fillMask(Framebuffer::White, full, 3, 3, 3, 4, 4);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 3 + 1);
+	CHECK(framebuffer.getPixel(4, 2) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(4, 4) == Framebuffer::White);
+
+	// A new clip replaces the previous one instead of narrowing it.
+	framebuffer.setClip(8.f, 8.f, 20.f, 20.f);
+	framebuffer.fill(Framebuffer::White, 0.f, 0.f, 10.f, 10.f);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 4 + 4);
+	framebuffer.resetClip();
+	framebuffer.fill(Framebuffer::White, 0.f, 0.f, 10.f, 10.f);
+	CHECK(countPixels(framebuffer, Framebuffer::White) == 100);
+}
+
+int main() {
+	testRectanglesFillThePixelsOfTheirCenters();
+	testRectanglesAreClippedIntoTheFramebuffer();
+	testMasksBlendTheColorByTheirCoverage();
+	testFillsStayWithinTheClip();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+#include "diagnostics.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+#include "stateexport.hpp"
+#include "test.hpp"
+
+#include <cmath>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+
+constexpr auto StartInput = Game::Input{ 0, 0, true };
+
+static void testStateEnteredByTimerOnlySimulatesTheRestOfTheStep() {
+	// The countdown of 833 milliseconds ends 33 milliseconds into the second step, so the ball may only move for the
+	// remaining 67 milliseconds of it.
+	auto game = Game{ 1, false };
+	game.onInput(StartInput);
+	game.onInput({});
+	game.update(800ms);
+	CHECK(game.getMatchState().kind == MatchState::Kind::COUNTDOWN);
+	CHECK(game.getMatchState().ballPosition.x == .5f);
+	game.update(100ms);
+	const auto state = game.getMatchState();
+	CHECK(state.kind == MatchState::Kind::PLAY);
+	const auto distance = std::fabs(static_cast<float>(state.ballPosition.x) - .5f);
+	CHECK(std::fabs(distance - .0004f * 67.f) < 1e-6f);
+}
+
+static void testSoundsStartAtTheirOffsetsWithinTheStep() {
+	// The ball hits the top wall 5 milliseconds into the step.
+	auto state = MatchState{};
+	state.kind = MatchState::Kind::PLAY;
+	state.ballPosition = { .5f, .05f };
+	state.ballVelocity = { 0.f, -.001f };
+	state.leftPaddlePosition = { .05f, .5f };
+	state.rightPaddlePosition = { .95f, .5f };
+	auto game = Game{ 1, false };
+	game.setMatchState(state);
+	game.update(20ms);
+	const auto& events = game.getSoundEvents();
+	CHECK(events.size() == 1);
+	CHECK(events[0].sound == Game::Sound::BEEP);
+	CHECK(std::fabs(events[0].delayMS - 5.f) < .01f);
+
+	// The events only cover the latest step.
+	game.update(1ms);
+	CHECK(game.getSoundEvents().empty());
+}
+
+static void testStepsResolveABoundedNumberOfCollisions() {
+	// The ball bounces between the walls so fast that a step would have thousands of collisions.
+	auto state = MatchState{};
+	state.kind = MatchState::Kind::PLAY;
+	state.ballPosition = { .5f, .5f };
+	state.ballVelocity = { 0.f, 10.f };
+	state.leftPaddlePosition = { .05f, .5f };
+	state.rightPaddlePosition = { .95f, .5f };
+	auto game = Game{ 1, false };
+	game.setMatchState(state);
+
+	// The step ends after its budget and carries the rest of its time, which is less than the step.
+	game.update(100ms);
+	auto events = game.getSoundEvents();
+	CHECK(events.size() == Game::MaxCollisionsPerStep);
+	CHECK(events.back().delayMS < 100.f);
+	CHECK(std::fabs(game.getCarriedMS() - (100.f - events.back().delayMS)) < .01f);
+
+	// The carried time is simulated by the next step before its own time.
+	const auto carried = game.getCarriedMS();
+	game.update(1ms);
+	events = game.getSoundEvents();
+	CHECK(events.size() == Game::MaxCollisionsPerStep);
+	CHECK(std::fabs(game.getCarriedMS() - (carried + 1.f - events.back().delayMS)) < .01f);
+
+	// Long steps carry at most the limit.
+	game.update(1000ms);
+	CHECK(game.getSoundEvents().size() == Game::MaxCollisionsPerStep);
+	CHECK(game.getCarriedMS() == float(Game::MaxCarriedMS));
+
+	// The ball has only moved for the simulated time and stays within the court.
+	const auto position = game.getMatchState().ballPosition;
+	CHECK(position.x == .5f);
+	CHECK(position.y > 0.f && position.y < 1.f);
+
+	// The carried time runs out once the ball slows down.
+	state = game.getMatchState();
+	state.ballVelocity = { 0.f, .0001f };
+	game.setMatchState(state);
+	game.update(8ms);
+	CHECK(game.getCarriedMS() == 0.f);
+}
+
+static void testTelemetryCanBeTurnedOff() {
+	const auto play = [](bool telemetry) {
+		auto game = Game{ 1, telemetry };
+		game.onInput(StartInput);
+		for (auto i = 0; i < 1000; i++) {
+			game.update(8ms);
+		}
+	};
+	const auto before = Telemetry::getStatistics().recorded;
+	play(false);
+	CHECK(Telemetry::getStatistics().recorded == before);
+	play(true);
+	CHECK(Telemetry::getStatistics().recorded > before);
+}
+
+// Plays with scripted paddle movements and returns the hash of the final state.
+static auto play(unsigned int seed, int steps) -> uint64_t {
+	auto game = Game{ seed, false };
+	game.onInput(StartInput);
+	for (auto i = 0; i < steps; i++) {
+		game.onInput({ static_cast<int8_t>(i / 50 % 3 - 1), static_cast<int8_t>(i / 70 % 3 - 1), i % 700 == 0 });
+		game.update(milliseconds(i % 3 == 2 ? 9 : 8));
+	}
+	return game.getStateHash();
+}
+
+static void testSameSeedAndInputPlayTheSame() {
+	CHECK(play(42, 500) == play(42, 500));
+
+	// The seed picks the direction of the serve out of four, so some of the other seeds play out differently.
+	auto differs = false;
+	for (auto seed = 43u; seed < 53u; seed++) {
+		differs = differs || play(seed, 500) != play(42, 500);
+	}
+	CHECK(differs);
+}
+
+#if defined(PONG_FIXED_POINT)
+static void testFixedPointPlaysTheSameInEveryBuild() {
+	// Recorded from a debug build. Floats would differ e.g. when the compiler contracts the swept collision test into
+	// fused multiply-adds.
+	CHECK(play(42, 5000) == 0x48c76d64839dcf24ull);
+}
+#endif
+
+static void testSteadyStateStepDoesNotAllocate() {
+	// Name the files after the process, so that the tests of both Scalar types can run at the same time.
+	#if defined(_WIN32)
+	const auto id = std::to_wstring(_getpid());
+	const auto segmentName = L"uwp-pong-state-game-test-" + id;
+	#else
+	const auto id = std::to_string(getpid());
+	const auto segmentName = "/uwp-pong-state-game-test-" + id;
+	#endif
+	auto sessionFilename = std::filesystem::temp_directory_path() / "game_test_session_";
+	sessionFilename += id;
+	sessionFilename += ".bin";
+
+	// Step like the app does, i.e. also record the session and publish the state for the tools. Play with paddles
+	// that follow the ball, so that the steps go through the countdown, collisions and goals.
+	auto game = Game{ 7 };
+	auto scene = Scene{};
+	auto session = Replay::Session{ sessionFilename, 7 };
+	auto stateExport = StateExport::Writer{ segmentName.c_str() };
+	CHECK(session.isOpen());
+	CHECK(stateExport.isOpen());
+	const auto step = [&](int tick) {
+		const auto state = game.getMatchState();
+		auto input = Game::Input{};
+		input.start = state.kind == MatchState::Kind::DIALOG;
+		input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y - .1f ? -1 : state.ballPosition.y > state.leftPaddlePosition.y + .1f ? 1 : 0;
+		input.player2Movement = static_cast<int8_t>(tick / 80 % 3 - 1);
+		const auto delta = std::chrono::milliseconds(tick % 3 == 2 ? 9 : 8);
+		game.onInput(input);
+		game.update(delta);
+		scene.clear();
+		game.render(scene);
+		session.record(game, input, delta);
+		stateExport.publish(game.getMatchState());
+	};
+
+	// The first steps may allocate e.g. the telemetry buffers of the thread.
+	auto tick = 0;
+	for (; tick < 1000; tick++) {
+		step(tick);
+	}
+
+	auto goals = 0;
+	for (; tick < 100000; tick++) {
+		const auto before = Diagnostics::getCounters();
+		const auto scoreBefore = game.getMatchState().player1Score + game.getMatchState().player2Score;
+		step(tick);
+		const auto after = Diagnostics::getCounters();
+		CHECK(after.allocations == before.allocations);
+		CHECK(after.referenceOperations == before.referenceOperations);
+		goals += game.getMatchState().player1Score + game.getMatchState().player2Score != scoreBefore;
+	}
+	CHECK(goals > 10);
+	CHECK(session.getRecordedTicks() > 0);
+	session.flush();
+	std::filesystem::remove(sessionFilename);
+}
+
+int main() {
+	testStateEnteredByTimerOnlySimulatesTheRestOfTheStep();
+	testSoundsStartAtTheirOffsetsWithinTheStep();
+	testStepsResolveABoundedNumberOfCollisions();
+	testTelemetryCanBeTurnedOff();
+	testSameSeedAndInputPlayTheSame();
+	#if defined(PONG_FIXED_POINT)
+	testFixedPointPlaysTheSameInEveryBuild();
+	#endif
+	testSteadyStateStepDoesNotAllocate();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+#include "glyphatlas.hpp"
+#include "softwareglyphatlas.hpp"
+#include "test.hpp"
+
+static auto isLit(const Framebuffer& framebuffer, int left, int top, int right, int bottom) -> bool {
+	for (auto y = top; y < bottom; y++) {
+		for (auto x = left; x < right; x++) {
+			if (framebuffer.getPixel(x, y) != Framebuffer::Black) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+static void testOnlyTheDistinctPrintableCharactersArePacked() {
+	auto atlas = GlyphAtlas{ 20.f, L"1010\n\x00e4" };
+	CHECK(atlas.getCharacters() == L"10");
+	CHECK(atlas.contains(L"0110"));
+	CHECK(atlas.contains(L"\n"));
+	CHECK(!atlas.contains(L"2"));
+
+	// Nothing is found before the glyphs are packed.
+	CHECK(!atlas.isPacked());
+	CHECK(atlas.findGlyph(L'1') == nullptr);
+	CHECK(atlas.pack([](wchar_t character) { return character == L'1' ? 5.f : 10.f; }, 24.f, 100.f, 100.f));
+	CHECK(atlas.findGlyph(L'1') != nullptr);
+	CHECK(atlas.findGlyph(L'1')->advance == 5.f);
+	CHECK(atlas.findGlyph(L'2') == nullptr);
+	CHECK(atlas.findGlyph(L'\n') == nullptr);
+	CHECK(atlas.measure(L"10\n10") == 30.f);
+}
+
+static void testGlyphsArePackedIntoRowsWithoutOverlap() {
+	// Five cells of 30 and their padding fit the first row, so the sixth one starts the next row.
+	auto atlas = GlyphAtlas{ 20.f, L"abcdefg" };
+	CHECK(atlas.pack([](wchar_t) { return 30.f; }, 24.f, 160.f, 100.f));
+	CHECK(atlas.getWidth() == 5 * 30.f + 4 * GlyphAtlas::Padding);
+	CHECK(atlas.getHeight() == 2 * 24.f + GlyphAtlas::Padding);
+	CHECK(atlas.findGlyph(L'e')->left == 4 * (30.f + GlyphAtlas::Padding));
+	CHECK(atlas.findGlyph(L'e')->top == 0.f);
+	CHECK(atlas.findGlyph(L'f')->left == 0.f);
+	CHECK(atlas.findGlyph(L'f')->top == 24.f + GlyphAtlas::Padding);
+	for (auto a : atlas.getCharacters()) {
+		for (auto b : atlas.getCharacters()) {
+			const auto& first = *atlas.findGlyph(a);
+			const auto& second = *atlas.findGlyph(b);
+			const auto overlaps = first.left < second.left + second.advance && second.left < first.left + first.advance &&
+				first.top < second.top + 24.f && second.top < first.top + 24.f;
+			CHECK(a == b || !overlaps);
+		}
+	}
+}
+
+static void testNothingIsPackedWhenTheGlyphsDoNotFit() {
+	auto atlas = GlyphAtlas{ 20.f, L"abcdefg" };
+	CHECK(!atlas.pack([](wchar_t) { return 30.f; }, 24.f, 160.f, 40.f));
+	CHECK(!atlas.isPacked());
+	CHECK(atlas.findGlyph(L'a') == nullptr);
+	CHECK(!atlas.pack([](wchar_t) { return 200.f; }, 24.f, 160.f, 1000.f));
+	CHECK(atlas.findGlyph(L'a') == nullptr);
+}
+
+static void testTextIsLaidOutCenteredOnItsPosition() {
+	auto atlas = GlyphAtlas{ 20.f, L"10" };
+	atlas.pack([](wchar_t character) { return character == L'1' ? 5.f : 10.f; }, 24.f, 100.f, 100.f);
+	auto glyphs = 0;
+	auto right = 0.f;
+	atlas.layoutCentered(L"10", 100.f, [&](const GlyphAtlas::Glyph& glyph, float left) {
+		CHECK(left == (glyphs == 0 ? 92.5f : 97.5f));
+		CHECK(glyph.advance == (glyphs == 0 ? 5.f : 10.f));
+		glyphs++;
+		right = left + glyph.advance;
+	});
+	CHECK(glyphs == 2);
+	CHECK(right == 107.5f);
+}
+
+static void testSoftwareGlyphsAreBlittedIntoTheFramebuffer() {
+	// The dots are scaled by two, so a glyph cell is 12 pixels wide and 18 pixels high with a margin of a dot above.
+	auto atlas = SoftwareGlyphAtlas{ 18.f, L"0123456789" };
+	CHECK(atlas.getAtlas().isPacked());
+	CHECK(atlas.getAtlas().findGlyph(L'1')->advance == 12.f);
+	auto framebuffer = Framebuffer{ 100, 40 };
+	atlas.drawCentered(framebuffer, Framebuffer::White, L"10", 50.f, 10.f);
+
+	// The stem of the one is its third column of dots, and the zero is drawn next to the one.
+	CHECK(framebuffer.getPixel(42, 12) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(43, 25) == Framebuffer::White);
+	CHECK(!isLit(framebuffer, 38, 10, 40, 28));
+	CHECK(isLit(framebuffer, 50, 10, 62, 28));
+
+	// Nothing is drawn outside the cells or into the margins of the glyphs.
+	CHECK(!isLit(framebuffer, 0, 0, 100, 12));
+	CHECK(!isLit(framebuffer, 0, 26, 100, 40));
+	CHECK(!isLit(framebuffer, 0, 0, 38, 40));
+	CHECK(!isLit(framebuffer, 62, 0, 100, 40));
+}
+
+static void testSoftwareGlyphsAreDrawnWithoutTheAtlasWhenTooLarge() {
+	// The glyphs of a huge font don't fit the atlas, so their dots are filled instead. A dot is 1000 pixels wide, so
+	// the stem of the one covers the pixels left of its center.
+	auto atlas = SoftwareGlyphAtlas{ 9000.f, L"1" };
+	CHECK(!atlas.getAtlas().isPacked());
+	auto framebuffer = Framebuffer{ 200, 60 };
+	atlas.drawCentered(framebuffer, Framebuffer::White, L"1", 100.f, -3000.f);
+	CHECK(framebuffer.getPixel(0, 0) == Framebuffer::White);
+	CHECK(framebuffer.getPixel(99, 59) == Framebuffer::White);
+	CHECK(!isLit(framebuffer, 100, 0, 200, 60));
+}
+
+int main() {
+	testOnlyTheDistinctPrintableCharactersArePacked();
+	testGlyphsArePackedIntoRowsWithoutOverlap();
+	testNothingIsPackedWhenTheGlyphsDoNotFit();
+	testTextIsLaidOutCenteredOnItsPosition();
+	testSoftwareGlyphsAreBlittedIntoTheFramebuffer();
+	testSoftwareGlyphsAreDrawnWithoutTheAtlasWhenTooLarge();
+	return EXIT_SUCCESS;
+}
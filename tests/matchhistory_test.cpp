@@ -0,0 +1,123 @@
+#include "matchhistory.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace MatchHistory;
+
+static auto makeRow(std::mt19937& random, uint64_t index) -> Row {
+	// The peak ball speed grows over the file so that a filter on it skips the early blocks.
+	auto row = Row{};
+	row[PLAYER1_SCORE] = static_cast<float>(random() % 11);
+	row[PLAYER2_SCORE] = static_cast<float>(random() % 11);
+	row[RALLIES] = static_cast<float>(random() % 40);
+	row[LONGEST_RALLY] = static_cast<float>(random() % 20);
+	row[PEAK_BALL_SPEED] = static_cast<float>(index / 1000) + std::uniform_real_distribution<float>{ 0.f, 1.f }(random);
+	row[DURATION] = static_cast<float>(random() % 300000);
+	return row;
+}
+
+static void testQueriesMatchAFullScan() {
+	const auto filename = std::filesystem::temp_directory_path() / "matchhistory_test.bin";
+	std::filesystem::remove(filename);
+
+	// Append enough rows to grow the file over several blocks.
+	constexpr auto RowCount = BlockRows * 5 + 123;
+	auto random = std::mt19937{ 3 };
+	auto rows = std::vector<Row>{};
+	{
+		auto file = File{ filename, File::Mode::APPEND };
+		CHECK(file.isOpen());
+		CHECK(file.getRowCount() == 0);
+		for (auto i = 0u; i < RowCount; i++) {
+			rows.push_back(makeRow(random, i));
+			file.append(rows.back());
+		}
+		CHECK(file.getRowCount() == RowCount);
+	}
+
+	const auto file = File{ filename, File::Mode::READ };
+	CHECK(file.isOpen());
+	CHECK(file.getRowCount() == RowCount);
+
+	const auto filters = std::vector<Range>{ { PEAK_BALL_SPEED, 15.f, INFINITY }, { PLAYER1_SCORE, 10.f, 10.f } };
+	const auto aggregate = file.query(filters, DURATION);
+	auto expected = Aggregate{};
+	for (const auto& row : rows) {
+		if (row[PEAK_BALL_SPEED] >= 15.f && row[PLAYER1_SCORE] == 10.f) {
+			expected.minimum = expected.rows == 0 ? row[DURATION] : std::min(expected.minimum, row[DURATION]);
+			expected.maximum = expected.rows == 0 ? row[DURATION] : std::max(expected.maximum, row[DURATION]);
+			expected.sum += row[DURATION];
+			expected.rows++;
+		}
+	}
+	CHECK(aggregate.rows > 0);
+	CHECK(aggregate.rows == expected.rows);
+	CHECK(aggregate.sum == expected.sum);
+	CHECK(aggregate.minimum == expected.minimum);
+	CHECK(aggregate.maximum == expected.maximum);
+
+	// The rows with a peak speed of 15 or more start in the fourth block.
+	CHECK(aggregate.skippedBlocks == 3);
+	CHECK(aggregate.scannedBlocks == 3);
+
+	// No rows match an empty range, so every block is skipped.
+	const auto none = file.query({ { RALLIES, 100.f, 200.f } }, RALLIES);
+	CHECK(none.rows == 0);
+	CHECK(none.scannedBlocks == 0);
+	CHECK(none.skippedBlocks == 6);
+	std::filesystem::remove(filename);
+}
+
+static void testReaderSeesRowsPublishedBeforeItWasOpened() {
+	const auto filename = std::filesystem::temp_directory_path() / "matchhistory_test_shared.bin";
+	std::filesystem::remove(filename);
+	auto random = std::mt19937{ 5 };
+	auto writer = File{ filename, File::Mode::APPEND };
+	for (auto i = 0u; i < 10; i++) {
+		writer.append(makeRow(random, i));
+	}
+
+	// The reader maps only the blocks that exist when it is opened, so it ignores the rows in later blocks.
+	const auto reader = File{ filename, File::Mode::READ };
+	CHECK(reader.getRowCount() == 10);
+	for (auto i = 10u; i < BlockRows * 2; i++) {
+		writer.append(makeRow(random, i));
+	}
+	CHECK(writer.getRowCount() == BlockRows * 2);
+	CHECK(reader.getRowCount() == BlockRows);
+	CHECK(reader.query({}, RALLIES).rows == BlockRows);
+	std::filesystem::remove(filename);
+}
+
+static void testMissingOrInvalidFilesAreNotOpened() {
+	const auto filename = std::filesystem::temp_directory_path() / "matchhistory_test_invalid.bin";
+	std::filesystem::remove(filename);
+
+	// A file that could not be opened behaves like an empty one.
+	auto missing = File{ filename, File::Mode::READ };
+	CHECK(!missing.isOpen());
+	CHECK(missing.getRowCount() == 0);
+	missing.append(Row{});
+	CHECK(missing.query({}, RALLIES).rows == 0);
+
+	// A file of another format is not accepted.
+	{
+		auto stream = std::fopen(filename.string().c_str(), "wb");
+		CHECK(stream);
+		const char garbage[64] = "not a match history";
+		std::fwrite(garbage, 1, sizeof(garbage), stream);
+		std::fclose(stream);
+	}
+	CHECK(!File(filename, File::Mode::READ).isOpen());
+	std::filesystem::remove(filename);
+}
+
+int main() {
+	testQueriesMatchAFullScan();
+	testReaderSeesRowsPublishedBeforeItWasOpened();
+	testMissingOrInvalidFilesAreNotOpened();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,76 @@
+#include "recorder.hpp"
+#include "test.hpp"
+
+#include <array>
+#include <iterator>
+
+using namespace std::chrono_literals;
+
+namespace {
+	constexpr auto Width = 2u;
+	constexpr auto Height = 2u;
+	constexpr auto FrameSize = Width * Height * 3;
+
+	// Submits a frame of a single gray level.
+	void submit(Recorder& recorder, uint8_t level, Recorder::Clock::time_point timestamp) {
+		auto pixels = std::array<uint8_t, Width * Height * 4>{};
+		pixels.fill(level);
+		recorder.submit(pixels.data(), Width * 4, Width, Height, timestamp);
+	}
+
+	// Reads back the luma of the first pixel of each frame in the stream.
+	auto readFrames(const std::filesystem::path& filename) -> std::vector<uint8_t> {
+		std::ifstream file(filename, std::ios::binary);
+		const auto contents = std::string(std::istreambuf_iterator<char>(file), {});
+		auto frames = std::vector<uint8_t>{};
+		for (auto offset = contents.find("FRAME\n"); offset != std::string::npos; offset = contents.find("FRAME\n", offset + 6 + FrameSize)) {
+			frames.push_back(static_cast<uint8_t>(contents[offset + 6]));
+		}
+		return frames;
+	}
+}
+
+int main() {
+	const auto filename = std::filesystem::temp_directory_path() / "recorder_test.y4m";
+	const auto start = Recorder::Clock::time_point{};
+
+	{
+		// Capture at an irregular rate: a second frame within the same 60 Hz slot and a gap of several slots.
+		Recorder recorder{ filename, 60 };
+		submit(recorder, 0, start);
+		submit(recorder, 64, start + 17ms);
+		submit(recorder, 96, start + 20ms);
+		submit(recorder, 128, start + 100ms);
+		recorder.finish(start + 150ms);
+
+		CHECK(recorder.getDroppedFrames() == 1);
+		CHECK(recorder.getDuplicatedFrames() == 7);
+		CHECK(recorder.getEncodedFrames() == 10);
+	}
+
+	// The stream header declares the rate the frames were placed at.
+	{
+		std::ifstream file(filename, std::ios::binary);
+		auto header = std::string{};
+		std::getline(file, header);
+		CHECK(header == "YUV4MPEG2 W2 H2 F60:1 Ip A1:1 C444");
+	}
+
+	// Slots 0 and 1 hold their captures, slots 2 to 5 repeat the second frame and slots 6 to 9 the last one.
+	const auto luma = [](int level) { return static_cast<uint8_t>(((66 * level + 129 * level + 25 * level + 128) >> 8) + 16); };
+	const auto expected = std::vector<uint8_t>{
+		luma(0), luma(64), luma(64), luma(64), luma(64), luma(64), luma(128), luma(128), luma(128), luma(128)
+	};
+	CHECK(readFrames(filename) == expected);
+
+	// Nothing is padded when the recording is only destroyed.
+	{
+		Recorder recorder{ filename, 60 };
+		submit(recorder, 0, start);
+		submit(recorder, 64, start + 50ms);
+	}
+	CHECK(readFrames(filename).size() == 4);
+
+	std::filesystem::remove(filename);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+#include "diagnostics.hpp"
+#include "replay.hpp"
+#include "test.hpp"
+
+using namespace std::chrono;
+
+// The tests of both Scalar types may run at the same time, so each of them uses files of its own.
+static auto getTempPath(const std::string& name) -> std::filesystem::path {
+	#if defined(PONG_FIXED_POINT)
+	return std::filesystem::temp_directory_path() / (name + "_fixed.bin");
+	#else
+	return std::filesystem::temp_directory_path() / (name + ".bin");
+	#endif
+}
+
+// Returns the input of a step of the scripted matches.
+static auto getInput(unsigned int seed, int step) -> Game::Input {
+	auto input = Game::Input{};
+	input.start = step % 1000 == 0;
+	input.player1Movement = static_cast<int8_t>((step + seed) / 40 % 3 - 1);
+	input.player2Movement = static_cast<int8_t>((step + seed) / 55 % 3 - 1);
+	return input;
+}
+
+// Records a match the way the simulation loop of the game does.
+static auto playMatch(unsigned int seed) -> Replay::Match {
+	auto match = Replay::Match{};
+	match.seed = seed;
+	auto game = Game{ seed, false };
+	for (auto i = 0; i < 3000; i++) {
+		const auto input = getInput(seed, i);
+		const auto delta = milliseconds(i % 3 == 2 ? 9 : 8);
+		game.onInput(input);
+		game.update(delta);
+		Replay::record(match, game, input, delta);
+	}
+	return match;
+}
+
+static void testRecordedMatchesVerify() {
+	auto corpus = std::vector<Replay::Match>{};
+	for (auto seed = 0u; seed < 8; seed++) {
+		corpus.push_back(playMatch(seed));
+	}
+	CHECK(Replay::verify(corpus).empty());
+
+	// Simulating the inputs again produces the same hashes as the live recording.
+	auto rerecorded = corpus[3];
+	Replay::record(rerecorded);
+	for (auto i = 0u; i < rerecorded.ticks.size(); i++) {
+		CHECK(rerecorded.ticks[i].hash == corpus[3].ticks[i].hash);
+	}
+}
+
+static void testFirstDivergingTickIsReported() {
+	auto corpus = std::vector<Replay::Match>{};
+	for (auto seed = 0u; seed < 4; seed++) {
+		corpus.push_back(playMatch(seed));
+	}
+	const auto expectedHash = corpus[1].ticks[100].hash;
+	corpus[1].ticks[100].hash ^= 1;
+	corpus[1].ticks[200].hash ^= 1;
+	corpus[3].seed = 99;
+
+	const auto mismatches = Replay::verify(corpus);
+	CHECK(mismatches.size() == 2);
+	CHECK(mismatches[0].match == 1);
+	CHECK(mismatches[0].tick == 100);
+	CHECK(mismatches[0].actualHash == expectedHash);
+	CHECK(mismatches[0].expectedHash == (expectedHash ^ 1));
+	CHECK(mismatches[1].match == 3);
+}
+
+static void testCorpusIsReadInBatches() {
+	const auto filename = getTempPath("replay_test");
+	auto corpus = std::vector<Replay::Match>{};
+	for (auto seed = 0u; seed < 5; seed++) {
+		corpus.push_back(playMatch(seed));
+	}
+	CHECK(Replay::save(filename, corpus));
+
+	auto reader = Replay::Reader{ filename };
+	CHECK(reader.isOpen());
+	CHECK(reader.getMatchCount() == 5);
+	auto loaded = std::vector<Replay::Match>{};
+	CHECK(reader.read(loaded, 2));
+	CHECK(loaded.size() == 2);
+	CHECK(reader.read(loaded, 10));
+	CHECK(loaded.size() == 5);
+	for (auto i = 0u; i < corpus.size(); i++) {
+		CHECK(loaded[i].seed == corpus[i].seed);
+		CHECK(loaded[i].ticks.size() == corpus[i].ticks.size());
+		for (auto j = 0u; j < corpus[i].ticks.size(); j++) {
+			CHECK(loaded[i].ticks[j].hash == corpus[i].ticks[j].hash);
+			CHECK(loaded[i].ticks[j].deltaMS == corpus[i].ticks[j].deltaMS);
+			CHECK(loaded[i].ticks[j].input.player1Movement == corpus[i].ticks[j].input.player1Movement);
+			CHECK(loaded[i].ticks[j].input.start == corpus[i].ticks[j].input.start);
+		}
+	}
+	CHECK(Replay::verify(loaded).empty());
+	std::filesystem::remove(filename);
+	CHECK(!Replay::Reader(filename).isOpen());
+}
+
+static void testSessionIsStreamedIntoAReplay() {
+	const auto filename = getTempPath("replay_test_session");
+	const auto copyFilename = getTempPath("replay_test_copy");
+	constexpr auto Seed = 5u;
+	const auto expected = playMatch(Seed);
+	{
+		auto session = Replay::Session{ filename, Seed };
+		CHECK(session.isOpen());
+		auto game = Game{ Seed, false };
+		auto allocations = uint64_t(0);
+		for (auto i = 0; i < 3000; i++) {
+			// Save a copy in the middle of a block, while the session keeps going.
+			if (i == 1500) {
+				session.save(copyFilename);
+			}
+			const auto input = getInput(Seed, i);
+			const auto delta = milliseconds(i % 3 == 2 ? 9 : 8);
+			game.onInput(input);
+			game.update(delta);
+			const auto before = Diagnostics::getCounters();
+			session.record(game, input, delta);
+			allocations += Diagnostics::getCounters().allocations - before.allocations;
+		}
+		CHECK(allocations == 0);
+		CHECK(session.getRecordedTicks() == 3000);
+		CHECK(session.getDroppedTicks() == 0);
+		session.flush();
+
+		// The session file is a replay of everything recorded so far, even while the session goes on.
+		auto corpus = std::vector<Replay::Match>{};
+		CHECK(Replay::load(filename, corpus));
+		CHECK(corpus.size() == 1);
+		CHECK(corpus[0].seed == Seed);
+		CHECK(corpus[0].ticks.size() == 3000);
+	}
+
+	// The session ends with every step written.
+	auto corpus = std::vector<Replay::Match>{};
+	CHECK(Replay::load(filename, corpus));
+	CHECK(corpus[0].ticks.size() == expected.ticks.size());
+	for (auto i = 0u; i < expected.ticks.size(); i++) {
+		CHECK(corpus[0].ticks[i].hash == expected.ticks[i].hash);
+	}
+	CHECK(Replay::verify(corpus).empty());
+
+	// The copy has at least the steps recorded before it was requested and replays the same way.
+	auto copy = std::vector<Replay::Match>{};
+	CHECK(Replay::load(copyFilename, copy));
+	CHECK(copy.size() == 1);
+	CHECK(copy[0].ticks.size() >= 1500);
+	CHECK(copy[0].ticks.size() <= 3000);
+	CHECK(Replay::verify(copy).empty());
+	std::filesystem::remove(filename);
+	std::filesystem::remove(copyFilename);
+}
+
+int main() {
+	testRecordedMatchesVerify();
+	testFirstDivergingTickIsReported();
+	testCorpusIsReadInBatches();
+	testSessionIsStreamedIntoAReplay();
+	return EXIT_SUCCESS;
+}
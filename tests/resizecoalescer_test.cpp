@@ -0,0 +1,95 @@
+#include "resizecoalescer.hpp"
+#include "test.hpp"
+
+#include <vector>
+
+using namespace std::chrono;
+
+// MockDevice records the rebuilds and takes a fixed time for each of them.
+class MockDevice final : public ResizeCoalescer::Device {
+public:
+	explicit MockDevice(VirtualClock& clock) : clock(clock) {}
+	void resize(const ResizeCoalescer::Target& target) override {
+		resizes.push_back(target);
+		clock.advance(5ms);
+	}
+
+	VirtualClock&                        clock;
+	std::vector<ResizeCoalescer::Target> resizes;
+};
+
+static void testStormIsCoalescedIntoOneRebuild() {
+	auto clock = VirtualClock{};
+	auto device = MockDevice{ clock };
+	auto coalescer = ResizeCoalescer{ device, clock };
+	coalescer.reset({ 800.f, 600.f, 96.f });
+
+	// A window drag between two frames only rebuilds for its last size.
+	for (auto i = 0; i < 100; i++) {
+		coalescer.requestSize(800.f + i, 600.f + i);
+	}
+	coalescer.requestDpi(144.f);
+	CHECK(device.resizes.empty());
+	CHECK(coalescer.isPending());
+	CHECK(coalescer.getTarget() == (ResizeCoalescer::Target{ 800.f, 600.f, 96.f }));
+
+	CHECK(coalescer.apply());
+	CHECK(!coalescer.isPending());
+	CHECK(device.resizes.size() == 1);
+	CHECK(device.resizes[0] == (ResizeCoalescer::Target{ 899.f, 699.f, 144.f }));
+	CHECK(coalescer.getTarget() == device.resizes[0]);
+
+	// Nothing is left to apply with the following frame.
+	CHECK(!coalescer.apply());
+	CHECK(device.resizes.size() == 1);
+
+	const auto& stats = coalescer.getStatistics();
+	CHECK(stats.requests == 101);
+	CHECK(stats.resizes == 1);
+	CHECK(stats.stallTime == 5ms);
+}
+
+static void testChangesThatCancelOutDontRebuild() {
+	auto clock = VirtualClock{};
+	auto device = MockDevice{ clock };
+	auto coalescer = ResizeCoalescer{ device, clock };
+	coalescer.reset({ 800.f, 600.f, 96.f });
+	coalescer.requestSize(1024.f, 768.f);
+	coalescer.requestDpi(120.f);
+	coalescer.requestSize(800.f, 600.f);
+	coalescer.requestDpi(96.f);
+	CHECK(!coalescer.apply());
+	CHECK(device.resizes.empty());
+	CHECK(coalescer.getStatistics().requests == 4);
+	CHECK(coalescer.getStatistics().resizes == 0);
+	CHECK(coalescer.getStatistics().stallTime == 0ms);
+}
+
+static void testEachFrameAppliesItsOwnChanges() {
+	auto clock = VirtualClock{};
+	auto device = MockDevice{ clock };
+	auto coalescer = ResizeCoalescer{ device, clock };
+	coalescer.reset({ 800.f, 600.f, 96.f });
+	for (auto frame = 1; frame <= 10; frame++) {
+		coalescer.requestSize(800.f + frame, 600.f);
+		coalescer.requestSize(800.f + frame * 2, 600.f);
+		CHECK(coalescer.apply());
+		CHECK(device.resizes.back().width == 800.f + frame * 2);
+	}
+	CHECK(device.resizes.size() == 10);
+	CHECK(coalescer.getStatistics().stallTime == 50ms);
+
+	// A reset takes over a target that was built elsewhere and drops the pending changes.
+	coalescer.requestDpi(192.f);
+	coalescer.reset({ 640.f, 480.f, 96.f });
+	CHECK(!coalescer.isPending());
+	CHECK(!coalescer.apply());
+	CHECK(device.resizes.size() == 10);
+}
+
+int main() {
+	testStormIsCoalescedIntoOneRebuild();
+	testChangesThatCancelOutDontRebuild();
+	testEachFrameAppliesItsOwnChanges();
+	return EXIT_SUCCESS;
+}
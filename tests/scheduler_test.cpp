@@ -0,0 +1,98 @@
+#include "scheduler.hpp"
+#include "test.hpp"
+
+using namespace std::chrono;
+
+// CountingClock is a virtual clock that counts how the scheduler waits.
+class CountingClock final : public Clock {
+public:
+	auto now() const -> TimePoint override { return clock.now(); }
+	void sleep(Duration duration) override { sleeps++; sleptTime += duration; clock.sleep(duration); }
+	void yield() override { yields++; clock.yield(); }
+	void advance(Duration duration) { clock.advance(duration); }
+
+	VirtualClock clock;
+	int          sleeps = 0;
+	int          yields = 0;
+	Duration     sleptTime = Duration::zero();
+};
+
+static void testFramesMeetTheTargetRate() {
+	auto clock = VirtualClock{};
+	auto scheduler = FrameScheduler{ clock, 100.0 };
+	for (auto i = 0; i < 10; i++) {
+		clock.advance(3ms);
+		CHECK(scheduler.waitForNextFrame() == 10ms);
+	}
+	const auto stats = scheduler.getStatistics();
+	CHECK(stats.frames == 10);
+	CHECK(stats.average == 10ms);
+	CHECK(stats.jitter == 0ns);
+	CHECK(stats.minimum == 10ms);
+	CHECK(stats.maximum == 10ms);
+}
+
+static void testSleepsBeforeSpinning() {
+	auto clock = CountingClock{};
+	auto scheduler = FrameScheduler{ clock, 100.0 };
+	scheduler.waitForNextFrame();
+	CHECK(clock.sleeps == 1);
+	CHECK(clock.sleptTime == 8ms);
+	CHECK(clock.yields == 2000);
+}
+
+static void testSmallDelayIsCaughtUp() {
+	auto clock = VirtualClock{};
+	auto scheduler = FrameScheduler{ clock, 100.0 };
+	CHECK(scheduler.waitForNextFrame() == 10ms);
+	clock.advance(15ms);
+	CHECK(scheduler.waitForNextFrame() == 15ms);
+	CHECK(scheduler.waitForNextFrame() == 5ms);
+	CHECK(scheduler.waitForNextFrame() == 10ms);
+}
+
+static void testLargeDelayResynchronizes() {
+	auto clock = VirtualClock{};
+	auto scheduler = FrameScheduler{ clock, 100.0 };
+	CHECK(scheduler.waitForNextFrame() == 10ms);
+	clock.advance(35ms);
+	CHECK(scheduler.waitForNextFrame() == 35ms);
+	CHECK(scheduler.waitForNextFrame() == 10ms);
+	CHECK(scheduler.waitForNextFrame() == 10ms);
+}
+
+static void testUnlimitedRateNeverWaits() {
+	auto clock = CountingClock{};
+	auto scheduler = FrameScheduler{ clock };
+	clock.advance(7ms);
+	CHECK(scheduler.waitForNextFrame() == 7ms);
+	CHECK(clock.sleeps == 0);
+	CHECK(clock.yields == 0);
+	scheduler.setTargetRate(50.0);
+	CHECK(scheduler.waitForNextFrame() == 20ms);
+}
+
+static void testStatisticsReset() {
+	auto clock = VirtualClock{};
+	auto scheduler = FrameScheduler{ clock, 100.0 };
+	scheduler.waitForNextFrame();
+	clock.advance(25ms);
+	scheduler.waitForNextFrame();
+	const auto stats = scheduler.getStatistics();
+	CHECK(stats.frames == 2);
+	CHECK(stats.minimum == 10ms);
+	CHECK(stats.maximum == 25ms);
+	CHECK(stats.jitter > 0ns);
+	scheduler.resetStatistics();
+	CHECK(scheduler.getStatistics().frames == 0);
+}
+
+int main() {
+	testFramesMeetTheTargetRate();
+	testSleepsBeforeSpinning();
+	testSmallDelayIsCaughtUp();
+	testLargeDelayResynchronizes();
+	testUnlimitedRateNeverWaits();
+	testStatisticsReset();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+#include "spectator.hpp"
+#include "test.hpp"
+
+#include <cmath>
+
+using namespace Spectator;
+
+namespace {
+	// Produces the match state of a ball that bounces around the court while the paddles follow it.
+	auto createState(int tick) -> MatchState {
+		auto state = MatchState{};
+		state.kind = MatchState::Kind::PLAY;
+		state.player1Score = (tick / 700) % 10;
+		state.player2Score = (tick / 1100) % 10;
+		state.ballPosition = { .5f + .45f * std::sin(tick * .031f), .5f + .45f * std::sin(tick * .017f) };
+		state.ballVelocity = { .004f * std::cos(tick * .031f), .004f * std::cos(tick * .017f) };
+		state.leftPaddlePosition = { .05f, (tick / 4) % 50 * .02f };
+		state.rightPaddlePosition = { .95f, .5f };
+		return state;
+	}
+
+	auto decodesTo(const Decoder& decoder, const QuantizedState& state) -> bool {
+		return quantize(decoder.getState()) == state;
+	}
+}
+
+int main() {
+	auto packet = std::vector<uint8_t>{};
+
+	// A lossless stream with immediate acknowledgements reproduces every quantized state.
+	{
+		Encoder encoder;
+		Decoder decoder;
+		MemoryTransport transport;
+		for (auto tick = 0; tick < 2000; tick++) {
+			const auto state = quantize(createState(tick));
+			encoder.encode(state, packet);
+			transport.send(packet);
+			CHECK(transport.receive(packet));
+			CHECK(decoder.decode(packet));
+			CHECK(decodesTo(decoder, state));
+			encoder.acknowledge(decoder.getSequence());
+		}
+		CHECK(encoder.getFullSnapshots() == 1);
+		CHECK(transport.getSentBytes() < transport.getSentPackets() * 16);
+	}
+
+	// Lost packets and late acknowledgements still decode since deltas only use acknowledged baselines.
+	{
+		Encoder encoder;
+		Decoder decoder;
+		auto acknowledgements = std::vector<uint32_t>{};
+		for (auto tick = 0; tick < 2000; tick++) {
+			const auto state = quantize(createState(tick));
+			encoder.encode(state, packet);
+			if (tick % 3 == 1) {
+				continue;
+			}
+			CHECK(decoder.decode(packet));
+			CHECK(decodesTo(decoder, state));
+			acknowledgements.push_back(decoder.getSequence());
+			if (acknowledgements.size() > 5) {
+				encoder.acknowledge(acknowledgements[acknowledgements.size() - 6]);
+			}
+		}
+	}
+
+	// An acknowledgement exactly 65536 packets old must not be taken for a recent one.
+	{
+		Encoder encoder;
+		Decoder decoder;
+		encoder.encode(quantize(createState(0)), packet);
+		CHECK(decoder.decode(packet));
+		encoder.acknowledge(decoder.getSequence());
+		for (auto tick = 1; tick <= 65536; tick++) {
+			encoder.encode(quantize(createState(tick)), packet);
+		}
+		CHECK((packet[0] & 0x80) != 0);
+		auto lateDecoder = Decoder{};
+		CHECK(lateDecoder.decode(packet));
+		CHECK(lateDecoder.getSequence() == 65537);
+		CHECK(decodesTo(lateDecoder, quantize(createState(65536))));
+
+		// The old decoder resynchronizes from the full snapshot too.
+		CHECK(decoder.decode(packet));
+		CHECK(decoder.getSequence() == 65537);
+	}
+
+	// Acknowledgements of packets that were never sent are ignored.
+	{
+		Encoder encoder;
+		encoder.encode(quantize(createState(0)), packet);
+		encoder.acknowledge(0);
+		encoder.acknowledge(100);
+		encoder.encode(quantize(createState(1)), packet);
+		CHECK(encoder.getFullSnapshots() == 2);
+	}
+
+	// Packets older than the history of the decoder are rejected.
+	{
+		Encoder encoder;
+		Decoder decoder;
+		auto first = std::vector<uint8_t>{};
+		encoder.encode(quantize(createState(0)), first);
+		for (auto tick = 1; tick < 100; tick++) {
+			encoder.encode(quantize(createState(tick)), packet);
+		}
+		CHECK(decoder.decode(packet));
+		CHECK(!decoder.decode(first));
+		CHECK(decodesTo(decoder, quantize(createState(99))));
+	}
+	return EXIT_SUCCESS;
+}
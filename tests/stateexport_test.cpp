@@ -0,0 +1,94 @@
+#include "game.hpp"
+#include "stateexport.hpp"
+#include "test.hpp"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace StateExport;
+using namespace std::chrono;
+
+namespace {
+	constexpr auto Steps = 100000;
+
+	auto isEqual(const Snapshot& a, const Snapshot& b) -> bool {
+		return std::memcmp(&a, &b, sizeof(Snapshot)) == 0;
+	}
+}
+
+int main() {
+	// Name the segment after the process, so that the tests of both Scalar types can run at the same time.
+	#if defined(_WIN32)
+	const auto name = L"uwp-pong-state-test-" + std::to_wstring(_getpid());
+	#else
+	const auto name = "/uwp-pong-state-test-" + std::to_string(getpid());
+	#endif
+
+	// There's nothing to read before the game has created the segment.
+	CHECK(!Reader{ name.c_str() }.isOpen());
+
+	auto writer = std::make_unique<Writer>(name.c_str());
+	CHECK(writer->isOpen());
+	auto game = Game{ 1, false };
+	auto published = std::vector<Snapshot>{ toSnapshot(game.getMatchState()) };
+	published.reserve(Steps + 1);
+	writer->publish(game.getMatchState());
+
+	// Play with paddles that follow the ball and publish each step while another thread reads the segment, as a tool
+	// in another process would. Every published snapshot is kept to check the reads against.
+	auto reader = Reader{ name.c_str() };
+	CHECK(reader.isOpen());
+	auto running = std::atomic<bool>{ true };
+	auto publisher = std::thread([&] {
+		for (auto step = 0; step < Steps; step++) {
+			const auto state = game.getMatchState();
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG;
+			input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y ? -1 : 1;
+			input.player2Movement = state.ballPosition.y < state.rightPaddlePosition.y ? -1 : 1;
+			game.onInput(input);
+			game.update(8ms);
+			published.push_back(toSnapshot(game.getMatchState()));
+			writer->publish(game.getMatchState());
+			if (step % 100 == 0) {
+				std::this_thread::yield();
+			}
+		}
+		running = false;
+	});
+
+	auto reads = std::vector<Snapshot>{};
+	auto snapshot = Snapshot{};
+	while (running) {
+		if (reader.read(snapshot) && (reads.empty() || !isEqual(snapshot, reads.back()))) {
+			reads.push_back(snapshot);
+		}
+	}
+	publisher.join();
+	CHECK(reads.size() > 10);
+
+	// Each read is one of the published steps, and no older than the one read before it.
+	auto step = size_t{ 0 };
+	for (const auto& read : reads) {
+		while (step < published.size() && !isEqual(read, published[step])) {
+			step++;
+		}
+		CHECK(step < published.size());
+	}
+
+	// The latest state is read once the game stops publishing.
+	CHECK(reader.read(snapshot));
+	CHECK(isEqual(snapshot, published.back()));
+
+	// The segment is removed along with the game.
+	writer = nullptr;
+	CHECK(!Reader{ name.c_str() }.isOpen());
+	return EXIT_SUCCESS;
+}
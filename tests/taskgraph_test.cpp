@@ -0,0 +1,139 @@
+#include "taskgraph.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
+namespace {
+	// Stubs are subsystems that record when they start and then block until the test lets them complete, so that the
+	// test controls the order of events instead of relying on how long each stub takes.
+	class Stubs final {
+	public:
+		auto add(std::string name) -> std::function<void()> {
+			return [this, name] {
+				std::unique_lock<std::mutex> lock{ mutex };
+				started.push_back(name);
+				condition.notify_all();
+				condition.wait(lock, [this, &name] { return released.count(name) > 0; });
+			};
+		}
+
+		void release(const std::string& name) {
+			std::lock_guard<std::mutex> lock{ mutex };
+			released.insert(name);
+			condition.notify_all();
+		}
+
+		void waitStarted(size_t count) {
+			std::unique_lock<std::mutex> lock{ mutex };
+			condition.wait(lock, [this, count] { return started.size() >= count; });
+		}
+
+		auto getStarted() -> std::vector<std::string> {
+			std::lock_guard<std::mutex> lock{ mutex };
+			return started;
+		}
+	private:
+		std::mutex               mutex;
+		std::condition_variable  condition;
+		std::vector<std::string> started;
+		std::set<std::string>    released;
+	};
+
+	auto contains(const std::vector<std::string>& names, const std::string& name) -> bool {
+		return std::find(names.begin(), names.end(), name) != names.end();
+	}
+
+	auto find(const std::vector<TaskGraph::Timing>& timings, const std::string& name) -> TaskGraph::Timing {
+		for (const auto& timing : timings) {
+			if (timing.name == name) {
+				return timing;
+			}
+		}
+		CHECK(false);
+		return {};
+	}
+}
+
+int main() {
+	// The startup of the app: the renderer and the game are needed for the first frame, while the sounds need both the
+	// audio engine and the game.
+	{
+		auto stubs = Stubs{};
+		auto graph = TaskGraph{};
+		const auto game = graph.add("game", stubs.add("game"));
+		const auto renderer = graph.add("renderer", stubs.add("renderer"));
+		const auto audio = graph.add("audio", stubs.add("audio"));
+		const auto sounds = graph.add("sounds", stubs.add("sounds"), { game, audio });
+
+		// The independent subsystems run at the same time, as each of them only completes once released.
+		graph.start();
+		stubs.waitStarted(3);
+		CHECK(!contains(stubs.getStarted(), "sounds"));
+
+		// The first frame only waits for the game and the renderer, while the sounds still wait for the audio engine.
+		stubs.release("game");
+		stubs.release("renderer");
+		graph.wait(game);
+		graph.wait(renderer);
+		graph.mark("first frame");
+		auto timings = graph.getTimings();
+		CHECK(!contains(stubs.getStarted(), "sounds"));
+		CHECK(find(timings, "sounds").status == TaskGraph::Timing::Status::PENDING);
+		CHECK(find(timings, "audio").status == TaskGraph::Timing::Status::PENDING);
+		CHECK(find(timings, "first frame").status == TaskGraph::Timing::Status::MILESTONE);
+		CHECK(graph.formatReport().find("sounds       pending") != std::string::npos);
+
+		// The sounds start once the last of their dependencies has completed.
+		stubs.release("audio");
+		stubs.waitStarted(4);
+		CHECK(stubs.getStarted().back() == "sounds");
+		stubs.release("sounds");
+		graph.wait(sounds);
+		graph.waitAll();
+		timings = graph.getTimings();
+		CHECK(find(timings, "sounds").start >= find(timings, "audio").end);
+		CHECK(find(timings, "sounds").start >= find(timings, "game").end);
+		CHECK(find(timings, "sounds").status == TaskGraph::Timing::Status::COMPLETED);
+		CHECK(graph.formatReport().find("renderer") != std::string::npos);
+	}
+
+	// A failing subsystem fails its dependents without running them and doesn't hold up the others.
+	{
+		auto stubs = Stubs{};
+		stubs.release("sounds");
+		stubs.release("renderer");
+		auto graph = TaskGraph{};
+		const auto audio = graph.add("audio", [] { throw std::runtime_error("no audio device"); });
+		const auto sounds = graph.add("sounds", stubs.add("sounds"), { audio });
+		const auto renderer = graph.add("renderer", stubs.add("renderer"));
+		graph.start();
+		graph.wait(renderer);
+		auto failed = false;
+		try {
+			graph.wait(sounds);
+		} catch (const std::runtime_error&) {
+			failed = true;
+		}
+		CHECK(failed);
+		graph.waitAll();
+		CHECK((stubs.getStarted() == std::vector<std::string>{ "renderer" }));
+		CHECK(find(graph.getTimings(), "sounds").status == TaskGraph::Timing::Status::FAILED);
+		CHECK(graph.formatReport().find("failed") != std::string::npos);
+	}
+
+	// Tasks can be handed to any executor, here one that runs them inline.
+	{
+		auto order = std::vector<std::string>{};
+		auto graph = TaskGraph{ [](std::function<void()> work) { work(); } };
+		const auto first = graph.add("first", [&] { order.push_back("first"); });
+		graph.add("second", [&] { order.push_back("second"); }, { first });
+		graph.start();
+		graph.waitAll();
+		CHECK((order == std::vector<std::string>{ "first", "second" }));
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#include "telemetry.hpp"
+#include "test.hpp"
+
+#include <vector>
+
+using namespace Telemetry;
+
+namespace {
+	// Plays a launch of the game: the start screen followed by the given number of matches with a few events each.
+	void playSession(const std::filesystem::path& filename, uint32_t matches) {
+		start(filename);
+		record(EventType::STATE_CHANGE, 0, 0, 0.f, 0.f, 0.f);
+		for (auto match = 1u; match <= matches; match++) {
+			record(EventType::STATE_CHANGE, match, 1, 0.f, 0.f, 0.f);
+			record(EventType::PADDLE_HIT, match, 0, .05f, .5f, .5f);
+			record(EventType::PADDLE_HIT, match, 1, .95f, .5f, .75f);
+			record(EventType::WALL_BOUNCE, match, 0, .5f, .0f, .75f);
+			record(EventType::GOAL, match, 1, 1.f, .5f, .75f);
+		}
+		stop();
+	}
+}
+
+int main() {
+	const auto filename = std::filesystem::temp_directory_path() / "telemetry_test.bin";
+	std::filesystem::remove(filename);
+
+	// Two launches append into the same log, where the second one starts its match numbers over.
+	playSession(filename, 2);
+	playSession(filename, 1);
+	const auto stats = getStatistics();
+	CHECK(stats.recorded == 17);
+	CHECK(stats.dropped == 0);
+	CHECK(stats.flushed == 17);
+
+	// The log has a single header even though it was opened twice.
+	CHECK(std::filesystem::file_size(filename) == 8 + 17 * sizeof(Event));
+
+	// Matches are told apart by their sessions and the start screens belong to no match.
+	auto summary = Summary{};
+	CHECK(aggregate(filename, summary));
+	CHECK(summary.events == 17);
+	CHECK(summary.sessions == 2);
+	CHECK(summary.matches == 3);
+	CHECK(summary.paddleHits[0] == 3);
+	CHECK(summary.paddleHits[1] == 3);
+	CHECK(summary.wallBounces[0] == 3);
+	CHECK(summary.goals[1] == 3);
+	CHECK(summary.maxPaddleHitSpeed == .75f);
+
+	// Each match is reported on its own in the order of the log.
+	auto matches = std::vector<MatchSummary>{};
+	summary = Summary{};
+	CHECK(aggregate(filename, summary, [&matches](const MatchSummary& match) { matches.push_back(match); }));
+	CHECK(matches.size() == 3);
+	CHECK(matches[0].match == 1 && matches[1].match == 2 && matches[2].match == 1);
+	CHECK(matches[0].session == matches[1].session);
+	CHECK(matches[1].session != matches[2].session);
+	for (const auto& match : matches) {
+		CHECK(match.events == 5);
+		CHECK(match.paddleHits[0] == 1 && match.paddleHits[1] == 1);
+		CHECK(match.goals[1] == 1);
+		CHECK(match.maxPaddleHitSpeed == .75f);
+		CHECK(match.endTimestamp >= match.startTimestamp);
+	}
+
+	std::filesystem::remove(filename);
+	return EXIT_SUCCESS;
+}
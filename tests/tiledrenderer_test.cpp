@@ -0,0 +1,129 @@
+#include "diagnostics.hpp"
+#include "game.hpp"
+#include "test.hpp"
+#include "tiledrenderer.hpp"
+
+using namespace std::chrono;
+
+static auto countLit(const Framebuffer& framebuffer, int left, int top, int right, int bottom) -> int {
+	auto count = 0;
+	for (auto y = top; y < bottom; y++) {
+		for (auto x = left; x < right; x++) {
+			count += framebuffer.getPixel(x, y) != Framebuffer::Black;
+		}
+	}
+	return count;
+}
+
+static auto createScene(float x, float y, float extent) -> Scene {
+	auto scene = Scene{};
+	auto rectangle = Rectangle{};
+	rectangle.position = { x, y };
+	rectangle.extent = { extent, extent };
+	scene.add(Scene::Brush::WHITE, rectangle);
+	return scene;
+}
+
+static void testScenesAreDrawnIntoTheirOwnTiles() {
+	// The tiles of a 2x2 grid of 260x200 pixels have the aspect ratio of the court, so each scene fills a quarter.
+	auto renderer = TiledRenderer{ 260, 200, 2, 2 };
+	CHECK(renderer.getTileCount() == 4);
+	auto scenes = std::vector<Scene>{ createScene(.5f, .5f, .5f), createScene(.5f, .5f, .5f), createScene(.25f, .25f, .25f) };
+	renderer.draw(scenes);
+	const auto& framebuffer = renderer.getFramebuffer();
+	CHECK(countLit(framebuffer, 0, 0, 130, 100) == 130 * 100);
+	CHECK(countLit(framebuffer, 130, 0, 260, 100) == 130 * 100);
+	CHECK(countLit(framebuffer, 0, 100, 65, 150) == 65 * 50);
+	CHECK(countLit(framebuffer, 65, 100, 260, 200) == 0);
+	CHECK(countLit(framebuffer, 0, 150, 65, 200) == 0);
+
+	// Scenes that don't fit the grid are left out, and a new frame starts from an empty framebuffer.
+	scenes.resize(8, createScene(.5f, .5f, .5f));
+	scenes[0] = createScene(.5f, .5f, 0.f);
+	renderer.draw(scenes);
+	CHECK(countLit(framebuffer, 0, 0, 130, 100) == 0);
+	CHECK(countLit(framebuffer, 0, 0, 260, 200) == 2 * 130 * 100 + 65 * 50);
+}
+
+static void testTilesKeepTheAspectRatioOfTheCourt() {
+	// The tiles are wider than the court, so the court is centered into each of them.
+	auto renderer = TiledRenderer{ 400, 100, 2, 1 };
+	renderer.draw({ createScene(.5f, .5f, .5f), createScene(.5f, .5f, .5f) });
+	const auto& framebuffer = renderer.getFramebuffer();
+	CHECK(countLit(framebuffer, 0, 0, 400, 100) == 2 * 130 * 100);
+	CHECK(countLit(framebuffer, 0, 0, 35, 100) == 0);
+	CHECK(countLit(framebuffer, 35, 0, 165, 100) == 130 * 100);
+	CHECK(countLit(framebuffer, 165, 0, 235, 100) == 0);
+}
+
+static void testTextStaysWithinItsTile() {
+	// The dialog description is far wider than a tile of 78x60 pixels.
+	auto game = Game{ 1, false };
+	auto scenes = std::vector<Scene>(3);
+	game.render(scenes[1]);
+	CHECK(!scenes[1].labels.empty());
+	auto renderer = TiledRenderer{ 234, 60, 3, 1 };
+	renderer.draw(scenes);
+	const auto& framebuffer = renderer.getFramebuffer();
+	CHECK(countLit(framebuffer, 78, 0, 156, 60) > 0);
+	CHECK(countLit(framebuffer, 0, 0, 78, 60) == 0);
+	CHECK(countLit(framebuffer, 156, 0, 234, 60) == 0);
+}
+
+static void testFramesOfPlayingMatchesDoNotAllocate() {
+	// Play a wall of matches with paddles that follow the ball, so that the scores and the dialogs change.
+	constexpr auto Matches = 64;
+	auto games = std::vector<Game>{};
+	games.reserve(Matches);
+	for (auto i = 0; i < Matches; i++) {
+		games.emplace_back(i, false);
+	}
+	auto scenes = std::vector<Scene>(Matches);
+	auto renderer = TiledRenderer{ 640, 480, 8, 8 };
+	const auto step = [&](int tick) {
+		for (auto i = 0; i < Matches; i++) {
+			const auto state = games[i].getMatchState();
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG;
+			input.player1Movement = state.ballPosition.y < state.leftPaddlePosition.y ? -1 : 1;
+			input.player2Movement = static_cast<int8_t>(tick / 80 % 3 - 1);
+			games[i].onInput(input);
+			games[i].update(8ms);
+			scenes[i].clear();
+			games[i].render(scenes[i]);
+		}
+	};
+
+	// Draw every glyph with the font sizes of the game once, so that the atlases contain all of them and frames only
+	// draw from then on.
+	auto glyphs = std::wstring{};
+	for (auto character = GlyphAtlas::FirstGlyph; character <= GlyphAtlas::LastGlyph; character++) {
+		glyphs.push_back(character);
+	}
+	auto warmup = std::vector<Scene>(Matches);
+	for (const auto fontSize : { .27f, .1f, .05f }) {
+		auto text = Text{};
+		text.text = glyphs;
+		text.fontSize = fontSize;
+		warmup[0].add(Scene::Brush::WHITE, text);
+	}
+	renderer.draw(warmup);
+
+	for (auto tick = 0; tick < 20000; tick++) {
+		step(tick);
+		if (tick % 8 == 0) {
+			const auto before = Diagnostics::getCounters();
+			renderer.draw(scenes);
+			CHECK(Diagnostics::getCounters().allocations == before.allocations);
+		}
+	}
+	CHECK(countLit(renderer.getFramebuffer(), 0, 0, 640, 480) > 0);
+}
+
+int main() {
+	testScenesAreDrawnIntoTheirOwnTiles();
+	testTilesKeepTheAspectRatioOfTheCourt();
+	testTextStaysWithinItsTile();
+	testFramesOfPlayingMatchesDoNotAllocate();
+	return EXIT_SUCCESS;
+}
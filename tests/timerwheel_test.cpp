@@ -0,0 +1,84 @@
+#include "test.hpp"
+#include "timerwheel.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std::chrono;
+
+// Entry is a timer that checks that it fires exactly at its deadline and reschedules itself a few times.
+struct Entry {
+	TimerWheel*       wheel = nullptr;
+	TimerWheel::Timer timer;
+	uint64_t          deadline = 0;
+	int               reschedules = 0;
+	int               fires = 0;
+};
+
+static void onExpire(void* context) {
+	auto& entry = *static_cast<Entry*>(context);
+	CHECK(entry.wheel->getTime() == entry.deadline);
+	entry.fires++;
+	if (entry.fires <= entry.reschedules) {
+		const auto delay = 1 + entry.deadline % 700;
+		entry.deadline += delay;
+		entry.wheel->schedule(entry.timer, milliseconds(delay), &onExpire, &entry);
+	}
+}
+
+static void testTimersFireAtTheirDeadlines() {
+	auto random = std::mt19937{ 7 };
+	auto wheel = TimerWheel{};
+
+	// Schedule timers over all levels of the wheel and cancel every seventh of them right away.
+	auto entries = std::vector<Entry>(3000);
+	for (auto& entry : entries) {
+		const auto delay = std::uniform_int_distribution<int>{ 1, 400000 }(random);
+		entry.wheel = &wheel;
+		entry.deadline = delay;
+		entry.reschedules = random() % 4 == 0 ? 3 : 0;
+		wheel.schedule(entry.timer, milliseconds(delay), &onExpire, &entry);
+	}
+	for (auto i = 0u; i < entries.size(); i += 7) {
+		wheel.cancel(entries[i].timer);
+	}
+
+	// Advance in steps of random length that are split at the expiries like the game splits its steps.
+	while (wheel.getTime() < 500000) {
+		auto remaining = milliseconds(std::uniform_int_distribution<int>{ 0, 300 }(random));
+		do {
+			auto expected = remaining;
+			for (const auto& entry : entries) {
+				if (entry.timer.isScheduled()) {
+					expected = std::min(expected, milliseconds(entry.deadline - wheel.getTime()));
+				}
+			}
+			const auto step = wheel.getTimeToNextExpiry(remaining);
+			CHECK(step == expected);
+			wheel.advance(step);
+			remaining -= step;
+		} while (remaining.count() > 0);
+	}
+
+	for (auto i = 0u; i < entries.size(); i++) {
+		CHECK(!entries[i].timer.isScheduled());
+		CHECK(entries[i].fires == (i % 7 == 0 ? 0 : entries[i].reschedules + 1));
+	}
+}
+
+static void testLimitWithoutTimers() {
+	auto wheel = TimerWheel{};
+	CHECK(wheel.getTimeToNextExpiry(100ms) == 100ms);
+	auto timer = TimerWheel::Timer{};
+	wheel.schedule(timer, 250ms, [](void*) {}, nullptr);
+	CHECK(wheel.getTimeToNextExpiry(100ms) == 100ms);
+	CHECK(wheel.getTimeToNextExpiry(300ms) == 250ms);
+	CHECK(wheel.getTimeToNextExpiry(0ms) == 0ms);
+}
+
+int main() {
+	testTimersFireAtTheirDeadlines();
+	testLimitWithoutTimers();
+	return EXIT_SUCCESS;
+}
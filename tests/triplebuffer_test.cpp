@@ -0,0 +1,56 @@
+#include "test.hpp"
+#include "triplebuffer.hpp"
+
+#include <thread>
+
+static void testReaderSeesTheNewestValue() {
+	auto buffer = TripleBuffer<int>{};
+	buffer.getWriteBuffer() = 1;
+	buffer.publish();
+	buffer.getWriteBuffer() = 2;
+	buffer.publish();
+	CHECK(buffer.read() == 2);
+
+	// The reader keeps its value until a new one is published.
+	CHECK(buffer.read() == 2);
+	buffer.getWriteBuffer() = 3;
+	CHECK(buffer.read() == 2);
+	buffer.publish();
+	CHECK(buffer.read() == 3);
+}
+
+static void testValuesArriveInOrderAcrossThreads() {
+	// The writer fills each buffer completely, so a torn value would show up as a mismatch between its fields.
+	struct Value {
+		int first = 0;
+		int values[64] = {};
+	};
+	constexpr auto Count = 200000;
+	auto buffer = TripleBuffer<Value>{};
+	auto writer = std::thread([&buffer] {
+		for (auto i = 1; i <= Count; i++) {
+			auto& value = buffer.getWriteBuffer();
+			value.first = i;
+			for (auto& field : value.values) {
+				field = i;
+			}
+			buffer.publish();
+		}
+	});
+	auto previous = 0;
+	while (previous < Count) {
+		const auto& value = buffer.read();
+		CHECK(value.first >= previous);
+		for (const auto field : value.values) {
+			CHECK(field == value.first);
+		}
+		previous = value.first;
+	}
+	writer.join();
+}
+
+int main() {
+	testReaderSeesTheNewestValue();
+	testValuesArriveInOrderAcrossThreads();
+	return EXIT_SUCCESS;
+}
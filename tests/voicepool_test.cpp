@@ -0,0 +1,110 @@
+#include "test.hpp"
+#include "voicepool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace {
+	// Mixer renders its voices into a buffer like XAudio2 does: each voice plays its queued samples back to back and
+	// only counts the samples it has played.
+	class Mixer final {
+	public:
+		void submit(int voice, uint32_t silence, const std::vector<float>& sound) {
+			queues[voice].insert(queues[voice].end(), silence, 0.f);
+			queues[voice].insert(queues[voice].end(), sound.begin(), sound.end());
+		}
+
+		void render(uint32_t samples) {
+			for (auto i = 0u; i < samples; i++) {
+				auto mixed = 0.f;
+				for (auto voice = 0; voice < VoicePool::VoiceCount; voice++) {
+					if (!queues[voice].empty()) {
+						mixed += queues[voice].front();
+						queues[voice].pop_front();
+						played[voice]++;
+					}
+				}
+				output.push_back(mixed);
+			}
+		}
+
+		// Finds the samples where a sound starts by its leading impulse.
+		auto findOnsets() const -> std::vector<uint64_t> {
+			auto onsets = std::vector<uint64_t>{};
+			for (auto i = 1u; i < output.size(); i++) {
+				if (output[i] - output[i - 1] > .5f) {
+					onsets.push_back(i);
+				}
+			}
+			return onsets;
+		}
+
+		auto getPosition() const -> uint64_t { return output.size(); }
+		auto getPlayedSamples() const -> const VoicePool::Samples& { return played; }
+	private:
+		std::deque<float>  queues[VoicePool::VoiceCount];
+		VoicePool::Samples played = {};
+		std::vector<float> output = { 0.f };
+	};
+
+	// A beep of a thousand samples that starts with an impulse.
+	auto createBeep() -> std::vector<float> {
+		auto beep = std::vector<float>(1000, .1f);
+		beep[0] = 1.f;
+		return beep;
+	}
+}
+
+int main() {
+	const auto beep = createBeep();
+
+	// Beeps that overlap the previous ones still start at the exact sample of their offset.
+	{
+		Mixer mixer;
+		VoicePool pool;
+		auto expected = std::vector<uint64_t>{};
+		for (auto i = 0u; i < 50; i++) {
+			const auto delay = (i * 37) % 400;
+			const auto playback = pool.schedule(mixer.getPlayedSamples(), delay, static_cast<uint32_t>(beep.size()));
+			CHECK(playback.lateness == 0);
+			expected.push_back(mixer.getPosition() + delay);
+			mixer.submit(playback.voice, playback.silence, beep);
+			mixer.render(350);
+		}
+		mixer.render(2000);
+		std::sort(expected.begin(), expected.end());
+		CHECK(mixer.findOnsets() == expected);
+	}
+
+	// A beep after an idle period is only delayed by its offset.
+	{
+		Mixer mixer;
+		VoicePool pool;
+		mixer.render(5000);
+		const auto playback = pool.schedule(mixer.getPlayedSamples(), 120, static_cast<uint32_t>(beep.size()));
+		CHECK(playback.silence == 120);
+		mixer.submit(playback.voice, playback.silence, beep);
+		mixer.render(2000);
+		CHECK(mixer.findOnsets() == std::vector<uint64_t>{ 5001 + 120 });
+	}
+
+	// When every voice is busy the beep starts as soon as the first voice drains and the lateness is reported.
+	{
+		Mixer mixer;
+		VoicePool pool;
+		for (auto i = 0; i < VoicePool::VoiceCount; i++) {
+			const auto playback = pool.schedule(mixer.getPlayedSamples(), 0, static_cast<uint32_t>(beep.size()));
+			CHECK(playback.lateness == 0);
+			mixer.submit(playback.voice, playback.silence, beep);
+			mixer.render(100);
+		}
+		const auto playback = pool.schedule(mixer.getPlayedSamples(), 50, static_cast<uint32_t>(beep.size()));
+		CHECK(playback.voice == 0);
+		CHECK(playback.lateness == 550);
+		mixer.submit(playback.voice, playback.silence, beep);
+		mixer.render(2000);
+		CHECK(mixer.findOnsets().back() == 1001);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+#include "tiledrenderer.hpp"
+
+#include <algorithm>
+#include <string>
+
+TiledRenderer::TiledRenderer(int width, int height, int columns, int rows) : framebuffer(width, height) {
+	// Split the framebuffer into equal sized tiles that each keep the aspect ratio of the court.
+	const auto tileWidth = static_cast<float>(width) / columns;
+	const auto tileHeight = static_cast<float>(height) / rows;
+	tiles.reserve(static_cast<size_t>(columns) * rows);
+	for (auto row = 0; row < rows; row++) {
+		for (auto column = 0; column < columns; column++) {
+			tiles.push_back(fitViewport(column * tileWidth, row * tileHeight, tileWidth, tileHeight));
+		}
+	}
+}
+
+void TiledRenderer::draw(const std::vector<Scene>& scenes) {
+	framebuffer.clear(Framebuffer::Black);
+	const auto count = std::min(scenes.size(), tiles.size());
+	for (auto i = size_t(0); i < count; i++) {
+		// Keep the text of a tile e.g. a long dialog description from spilling into the neighboring tiles.
+		const auto& tile = tiles[i];
+		framebuffer.setClip(tile.left, tile.top, tile.left + tile.width, tile.top + tile.height);
+		for (const auto& shape : scenes[i].shapes) {
+			fill(getColor(shape.brush), shape.rectangle, tile);
+		}
+		for (const auto& label : scenes[i].labels) {
+			fill(getColor(label.brush), label.text, tile);
+		}
+	}
+	framebuffer.resetClip();
+}
+
+auto TiledRenderer::fitViewport(float left, float top, float width, float height) -> Viewport {
+	constexpr auto DesiredAspect = 1.3f;
+	auto result = Viewport{ left, top, width, height };
+	const auto aspect = width / height;
+	if (aspect > DesiredAspect) {
+		result.width = DesiredAspect * height;
+		result.left += (width - result.width) / 2.f;
+	} else if (aspect < DesiredAspect) {
+		result.height = width / DesiredAspect;
+		result.top += (height - result.height) / 2.f;
+	}
+	return result;
+}
+
+void TiledRenderer::fill(uint32_t color, const Rectangle& rect, const Viewport& area) {
+	const auto left = static_cast<float>(-rect.extent.x + rect.position.x);
+	const auto top = static_cast<float>(-rect.extent.y + rect.position.y);
+	const auto right = static_cast<float>(rect.extent.x + rect.position.x);
+	const auto bottom = static_cast<float>(rect.extent.y + rect.position.y);
+	framebuffer.fill(color,
+		area.left + left * area.width,
+		area.top + top * area.height,
+		area.left + right * area.width,
+		area.top + bottom * area.height);
+}
+
+void TiledRenderer::fill(uint32_t color, const Text& text, const Viewport& area) {
+	const auto& atlas = getGlyphAtlas(text.fontSize * area.height, text.text);
+	const auto x = area.left + static_cast<float>(text.position.x) * area.width;
+	const auto y = area.top + static_cast<float>(text.position.y) * area.height;
+	atlas.drawCentered(framebuffer, color, text.text, x, y);
+}
+
+auto TiledRenderer::getGlyphAtlas(float fontSize, std::wstring_view text) -> const SoftwareGlyphAtlas& {
+	// Rebuild the atlas of the font size with the new glyphs when the text uses glyphs it doesn't contain yet.
+	for (auto& atlas : glyphAtlases) {
+		if (atlas.getFontSize() == fontSize) {
+			if (!atlas.contains(text)) {
+				atlas = SoftwareGlyphAtlas(fontSize, atlas.getCharacters() + std::wstring(text));
+			}
+			return atlas;
+		}
+	}
+	return glyphAtlases.emplace_back(fontSize, text);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "framebuffer.hpp"
+#include "scene.hpp"
+#include "softwareglyphatlas.hpp"
+
+// TiledRenderer draws the scenes of many matches into the tiles of a single software framebuffer, e.g. for a wall
+// that monitors the matches of a server.
+//
+// The tiles of the grid are laid out once and keep the aspect ratio of the court. All tiles have the same size, so
+// they share the glyph atlas of each font size, and a frame draws every scene in a single pass that only fills
+// rectangles and blits glyphs.
+class TiledRenderer final {
+public:
+	TiledRenderer(int width, int height, int columns, int rows);
+
+	auto getTileCount() const -> int { return static_cast<int>(tiles.size()); }
+	auto getFramebuffer() const -> const Framebuffer& { return framebuffer; }
+
+	// Draws the scenes into the tiles row by row. Scenes that don't fit the grid are left out.
+	void draw(const std::vector<Scene>& scenes);
+private:
+	// Viewport is the area of a tile where the normalized game coordinates are mapped into.
+	struct Viewport {
+		float left;
+		float top;
+		float width;
+		float height;
+	};
+
+	static auto fitViewport(float left, float top, float width, float height) -> Viewport;
+	static auto getColor(Scene::Brush brush) -> uint32_t { return brush == Scene::Brush::BLACK ? Framebuffer::Black : Framebuffer::White; }
+
+	void fill(uint32_t color, const Rectangle& rect, const Viewport& area);
+	void fill(uint32_t color, const Text& text, const Viewport& area);
+
+	auto getGlyphAtlas(float fontSize, std::wstring_view text) -> const SoftwareGlyphAtlas&;
+
+	Framebuffer                     framebuffer;
+	std::vector<Viewport>           tiles;
+	std::vector<SoftwareGlyphAtlas> glyphAtlases;
+};
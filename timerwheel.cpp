@@ -0,0 +1,121 @@
+#include "timerwheel.hpp"
+
+#include <algorithm>
+
+void TimerWheel::schedule(Timer& timer, std::chrono::milliseconds delay, Callback callback, void* context) {
+	// Timers always expire in the future so that a callback can't reschedule itself into the slot being expired.
+	constexpr auto MaxDelay = (uint64_t(1) << (SlotBits * LevelCount)) - 1;
+	cancel(timer);
+	timer.callback = callback;
+	timer.context = context;
+	timer.deadline = time + std::clamp<uint64_t>(delay.count() > 0 ? delay.count() : 0, 1, MaxDelay);
+	insert(timer);
+	scheduledTimers++;
+}
+
+void TimerWheel::cancel(Timer& timer) {
+	if (timer.link) {
+		*timer.link = timer.next;
+		if (timer.next) {
+			timer.next->link = timer.link;
+		}
+		timer.next = nullptr;
+		timer.link = nullptr;
+		scheduledTimers--;
+	}
+}
+
+void TimerWheel::advance(std::chrono::milliseconds delta) {
+	// An empty wheel can skip the time at once.
+	if (scheduledTimers == 0) {
+		time += delta.count();
+		return;
+	}
+
+	for (auto i = 0ll; i < delta.count(); i++) {
+		time++;
+
+		// Move the timers of the upper levels down as the lower levels wrap around. Higher levels go first as they
+		// may refill the slot that the level below is about to cascade.
+		auto wrappedLevels = 0;
+		while (wrappedLevels + 1 < LevelCount && (time & ((uint64_t(1) << (SlotBits * (wrappedLevels + 1))) - 1)) == 0) {
+			wrappedLevels++;
+		}
+		for (auto level = wrappedLevels; level > 0; level--) {
+			cascade(level);
+		}
+		expire();
+	}
+}
+
+auto TimerWheel::getTimeToNextExpiry(std::chrono::milliseconds limit) const -> std::chrono::milliseconds {
+	if (scheduledTimers == 0 || limit.count() <= 0) {
+		return limit;
+	}
+
+	// A timer that expires within the limit can only be in the slots of each level that cover the times within the
+	// limit, although those slots may also contain timers of later rounds of the level.
+	const auto first = time + 1;
+	const auto last = time + limit.count();
+	auto next = last;
+	for (auto level = 0; level < LevelCount; level++) {
+		const auto firstSlot = first >> (SlotBits * level);
+		const auto lastSlot = std::min(last >> (SlotBits * level), firstSlot + SlotCount - 1);
+		for (auto slot = firstSlot; slot <= lastSlot; slot++) {
+			for (auto timer = slots[level][slot & (SlotCount - 1)]; timer; timer = timer->next) {
+				if (timer->deadline >= first && timer->deadline < next) {
+					next = timer->deadline;
+				}
+			}
+		}
+	}
+	return std::chrono::milliseconds(next - time);
+}
+
+void TimerWheel::insert(Timer& timer) {
+	// Pick the lowest level whose range covers the remaining time.
+	const auto remaining = timer.deadline - time;
+	auto level = 0;
+	while (level + 1 < LevelCount && remaining >= (uint64_t(1) << (SlotBits * (level + 1)))) {
+		level++;
+	}
+	auto& head = slots[level][(timer.deadline >> (SlotBits * level)) & (SlotCount - 1)];
+	timer.next = head;
+	timer.link = &head;
+	if (head) {
+		head->link = &timer.next;
+	}
+	head = &timer;
+}
+
+void TimerWheel::cascade(int level) {
+	auto& head = slots[level][(time >> (SlotBits * level)) & (SlotCount - 1)];
+	auto timer = head;
+	head = nullptr;
+	while (timer) {
+		const auto next = timer->next;
+		insert(*timer);
+		timer = next;
+	}
+}
+
+void TimerWheel::expire() {
+	// Detach the slot before running the callbacks as they may schedule and cancel timers.
+	auto& head = slots[0][time & (SlotCount - 1)];
+	auto timer = head;
+	head = nullptr;
+	if (timer) {
+		timer->link = &timer;
+	}
+	while (timer) {
+		auto& expired = *timer;
+		timer = expired.next;
+		if (timer) {
+			timer->link = &timer;
+		}
+		expired.next = nullptr;
+		expired.link = nullptr;
+		scheduledTimers--;
+		expired.callback(expired.context);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// TimerWheel is a hierarchical timer wheel that is driven by the simulation time with a millisecond resolution.
+//
+// Each level has 64 slots and covers 64 times the range of the level below it. Timers are linked into the slot of
+// their deadline, so scheduling and cancelling are constant time and a slot is only touched when time reaches it or
+// when its timers cascade down one level. Timers are owned by the caller, so scheduling never allocates.
+class TimerWheel final {
+public:
+	using Callback = void(*)(void* context);
+
+	// Timer is a single scheduled callback. A timer must stay alive while it is scheduled.
+	class Timer final {
+	public:
+		auto isScheduled() const -> bool { return link != nullptr; }
+	private:
+		friend class TimerWheel;
+
+		Callback callback = nullptr;
+		void*    context = nullptr;
+		uint64_t deadline = 0;
+		Timer*   next = nullptr;
+		Timer**  link = nullptr; // the pointer that points to this timer
+	};
+
+	void schedule(Timer& timer, std::chrono::milliseconds delay, Callback callback, void* context);
+	void cancel(Timer& timer);
+	void advance(std::chrono::milliseconds delta);
+	auto getTime() const -> uint64_t { return time; }
+
+	// Returns the time until the next timer expires or the limit when no timer expires within it.
+	auto getTimeToNextExpiry(std::chrono::milliseconds limit) const -> std::chrono::milliseconds;
+private:
+	static constexpr auto SlotBits = 6;
+	static constexpr auto SlotCount = 1 << SlotBits;
+	static constexpr auto LevelCount = 4;
+
+	void insert(Timer& timer);
+	void cascade(int level);
+	void expire();
+
+	std::array<std::array<Timer*, SlotCount>, LevelCount> slots = {};
+	uint64_t                                              time = 0;
+	int                                                   scheduledTimers = 0;
+};
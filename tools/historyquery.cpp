@@ -0,0 +1,113 @@
+#include "matchhistory.hpp"
+#include "matchstate.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace MatchHistory;
+using namespace std::chrono;
+
+// Prints aggregates of the matches in a match history file, e.g. the win rate of player 1 in fast matches:
+//
+//   historyquery history.bin --where peak-ball-speed 0.002 inf --win-rate
+namespace {
+	constexpr const char* ColumnNames[COLUMN_COUNT] = {
+		"player1-score", "player2-score", "rallies", "longest-rally", "peak-ball-speed", "duration"
+	};
+
+	auto usage() -> int {
+		std::fprintf(stderr, "usage: historyquery FILE [--where COLUMN MIN MAX]... [--column COLUMN] [--win-rate]\n");
+		std::fprintf(stderr, "columns:");
+		for (const auto name : ColumnNames) {
+			std::fprintf(stderr, " %s", name);
+		}
+		std::fprintf(stderr, "\n");
+		return EXIT_FAILURE;
+	}
+
+	auto parseColumn(const char* name, Column& column) -> bool {
+		for (auto i = 0; i < COLUMN_COUNT; i++) {
+			if (std::strcmp(name, ColumnNames[i]) == 0) {
+				column = static_cast<Column>(i);
+				return true;
+			}
+		}
+		std::fprintf(stderr, "unknown column: %s\n", name);
+		return false;
+	}
+
+	auto parseValue(const char* text, float& value) -> bool {
+		char* end = nullptr;
+		value = std::strtof(text, &end);
+		if (end == text || *end != '\0') {
+			std::fprintf(stderr, "invalid value: %s\n", text);
+			return false;
+		}
+		return true;
+	}
+
+	void print(const char* name, const Aggregate& aggregate, duration<double, std::milli> time) {
+		const auto mean = aggregate.rows > 0 ? aggregate.sum / aggregate.rows : 0.0;
+		std::printf("%s: rows=%llu sum=%.1f mean=%.4f min=%g max=%g\n", name,
+			static_cast<unsigned long long>(aggregate.rows), aggregate.sum, mean, aggregate.minimum, aggregate.maximum);
+		std::printf("blocks: scanned=%llu skipped=%llu time=%.3fms\n",
+			static_cast<unsigned long long>(aggregate.scannedBlocks), static_cast<unsigned long long>(aggregate.skippedBlocks),
+			time.count());
+	}
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		return usage();
+	}
+
+	auto filters = std::vector<Range>{};
+	auto column = DURATION;
+	auto winRate = false;
+	for (auto i = 2; i < argc; i++) {
+		const auto argument = std::string{ argv[i] };
+		if (argument == "--where" && i + 3 < argc) {
+			auto range = Range{};
+			if (!parseColumn(argv[i + 1], range.column) || !parseValue(argv[i + 2], range.minimum) || !parseValue(argv[i + 3], range.maximum)) {
+				return usage();
+			}
+			filters.push_back(range);
+			i += 3;
+		} else if (argument == "--column" && i + 1 < argc) {
+			if (!parseColumn(argv[++i], column)) {
+				return usage();
+			}
+		} else if (argument == "--win-rate") {
+			winRate = true;
+		} else {
+			return usage();
+		}
+	}
+
+	const auto file = File{ argv[1], File::Mode::READ };
+	if (!file.isOpen()) {
+		std::fprintf(stderr, "cannot open a match history: %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	std::printf("file: rows=%llu\n", static_cast<unsigned long long>(file.getRowCount()));
+
+	auto startTime = steady_clock::now();
+	const auto aggregate = file.query(filters, column);
+	print(ColumnNames[column], aggregate, steady_clock::now() - startTime);
+
+	// Player 1 has won the matches where it reached the winning score.
+	if (winRate) {
+		auto winFilters = filters;
+		winFilters.push_back({ PLAYER1_SCORE, float(MatchState::WinningScore), INFINITY });
+		startTime = steady_clock::now();
+		const auto wins = file.query(winFilters, PLAYER1_SCORE);
+		print("player1-wins", wins, steady_clock::now() - startTime);
+		const auto rate = aggregate.rows > 0 ? double(wins.rows) / aggregate.rows : 0.0;
+		std::printf("win-rate: %.4f\n", rate);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#include "game.hpp"
+#include "recorder.hpp"
+#include "scheduler.hpp"
+#include "tiledrenderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+
+// Plays many matches between bots in real time and draws them all into a single monitoring wall, optionally recording
+// the wall into a Y4M video, e.g.
+//
+//   matchwall 256 10 wall.y4m
+namespace {
+	constexpr auto DefaultMatches = 256;
+	constexpr auto DefaultSeconds = 10;
+	constexpr auto Width = 1920;
+	constexpr auto Height = 1080;
+	constexpr auto FrameRate = 60;
+	constexpr auto CourtAspect = 1.3;
+	constexpr auto MaxFrameTime = 250ms;
+
+	auto usage() -> int {
+		std::fprintf(stderr, "usage: matchwall [MATCHES] [SECONDS] [VIDEO]\n");
+		return EXIT_FAILURE;
+	}
+
+	// Steers a paddle towards the ball, but only when the ball comes towards it, so that the bots miss now and then.
+	auto steer(float paddle, float ball, bool incoming) -> int8_t {
+		constexpr auto DeadZone = .03f;
+		if (!incoming) {
+			return 0;
+		}
+		return ball < paddle - DeadZone ? -1 : ball > paddle + DeadZone ? 1 : 0;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	if (argc > 4) {
+		return usage();
+	}
+	const auto matches = argc > 1 ? std::atoi(argv[1]) : DefaultMatches;
+	const auto seconds = argc > 2 ? std::atoi(argv[2]) : DefaultSeconds;
+	if (matches <= 0 || seconds <= 0) {
+		return usage();
+	}
+
+	// Pick the number of columns where the tiles of the wall waste the least of the target.
+	const auto columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(matches * double(Width) / Height / CourtAspect))));
+	const auto rows = (matches + columns - 1) / columns;
+	auto renderer = TiledRenderer{ Width, Height, columns, rows };
+	auto recorder = std::unique_ptr<Recorder>{};
+	if (argc > 3) {
+		recorder = std::make_unique<Recorder>(argv[3], FrameRate);
+	}
+
+	auto games = std::vector<Game>{};
+	games.reserve(matches);
+	for (auto i = 0; i < matches; i++) {
+		games.emplace_back(i, false);
+	}
+	auto scenes = std::vector<Scene>(matches);
+
+	// Update every match by the duration of the previous frame and draw the wall, like the game draws its only match.
+	auto clock = SteadyClock{};
+	auto scheduler = FrameScheduler{ clock, double(FrameRate) };
+	auto pendingTime = Clock::Duration::zero();
+	auto simulateTime = 0.0;
+	auto drawTime = 0.0;
+	const auto frames = seconds * FrameRate;
+	for (auto frame = 0; frame < frames; frame++) {
+		pendingTime += std::min<Clock::Duration>(scheduler.waitForNextFrame(), MaxFrameTime);
+		const auto delta = duration_cast<milliseconds>(pendingTime);
+		pendingTime -= delta;
+
+		const auto startTime = steady_clock::now();
+		for (auto i = 0; i < matches; i++) {
+			const auto state = games[i].getMatchState();
+			const auto ball = static_cast<float>(state.ballPosition.y);
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG;
+			input.player1Movement = steer(static_cast<float>(state.leftPaddlePosition.y), ball, state.ballVelocity.x < 0.f);
+			input.player2Movement = steer(static_cast<float>(state.rightPaddlePosition.y), ball, state.ballVelocity.x > 0.f);
+			games[i].onInput(input);
+			games[i].update(delta);
+			scenes[i].clear();
+			games[i].render(scenes[i]);
+		}
+		const auto drawStartTime = steady_clock::now();
+		renderer.draw(scenes);
+		const auto endTime = steady_clock::now();
+		simulateTime += duration<double, std::milli>(drawStartTime - startTime).count();
+		drawTime += duration<double, std::milli>(endTime - drawStartTime).count();
+
+		if (recorder) {
+			const auto& framebuffer = renderer.getFramebuffer();
+			recorder->submit(reinterpret_cast<const uint8_t*>(framebuffer.getPixels()), Width * sizeof(uint32_t), Width,
+				Height, Recorder::Clock::now());
+		}
+	}
+
+	const auto stats = scheduler.getStatistics();
+	std::printf("%d matches in %dx%d tiles, %d frames at %.1f Hz: simulate %.3f ms, draw %.3f ms per frame\n", matches,
+		columns, rows, frames, 1e9 / stats.average.count(), simulateTime / frames, drawTime / frames);
+	if (recorder) {
+		recorder->finish(Recorder::Clock::now());
+		std::printf("recorded %s: %lld frames encoded, %lld dropped, %lld duplicated\n", argv[3],
+			recorder->getEncodedFrames(), recorder->getDroppedFrames(), recorder->getDuplicatedFrames());
+	}
+	return EXIT_SUCCESS;
+}
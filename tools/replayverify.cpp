@@ -0,0 +1,155 @@
+#include "replay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace std::chrono;
+
+// Records a corpus of matches played by bots and verifies that a corpus still plays out the same way, e.g.
+//
+//   replayverify record corpus.bin 100000
+//   replayverify verify corpus.bin
+namespace {
+	constexpr auto DefaultMatches = 100000u;
+	constexpr auto DefaultTicks = 2000u;
+	constexpr auto BatchSize = size_t(4096);
+
+	auto usage() -> int {
+		std::fprintf(stderr, "usage: replayverify record FILE [MATCHES] [TICKS]\n");
+		std::fprintf(stderr, "       replayverify verify FILE\n");
+		return EXIT_FAILURE;
+	}
+
+	// Runs the work for each index on all cores.
+	template <typename Work>
+	void runParallel(size_t count, Work work) {
+		auto next = std::atomic<size_t>{ 0 };
+		const auto run = [&]() {
+			for (auto i = next++; i < count; i = next++) {
+				work(i);
+			}
+		};
+		auto workers = std::vector<std::thread>{};
+		for (auto i = 1u; i < std::thread::hardware_concurrency(); i++) {
+			workers.emplace_back(run);
+		}
+		run();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	// Steers a paddle towards the ball with an aim error that changes every now and then, so that the bots miss the
+	// ball often enough to score goals.
+	auto steer(float paddle, float ball, float aimError) -> int8_t {
+		constexpr auto DeadZone = .02f;
+		const auto target = ball + aimError;
+		return target < paddle - DeadZone ? -1 : target > paddle + DeadZone ? 1 : 0;
+	}
+
+	// Plays a match with bots at a simulation rate of about 120 Hz with occasional hitches.
+	auto play(unsigned int seed, unsigned int ticks) -> Replay::Match {
+		auto random = std::mt19937{ seed };
+		auto aim = std::uniform_real_distribution<float>{ -.12f, .12f };
+		auto match = Replay::Match{};
+		match.seed = seed;
+		match.ticks.reserve(ticks);
+		auto game = Game{ seed, false };
+		auto aimErrors = std::array<float, 2>{};
+		for (auto tick = 0u; tick < ticks; tick++) {
+			if (tick % 60 == 0) {
+				aimErrors = { aim(random), aim(random) };
+			}
+			const auto state = game.getMatchState();
+			auto input = Game::Input{};
+			input.start = state.kind == MatchState::Kind::DIALOG && random() % 30 == 0;
+			const auto ball = static_cast<float>(state.ballPosition.y);
+			input.player1Movement = steer(static_cast<float>(state.leftPaddlePosition.y), ball, aimErrors[0]);
+			input.player2Movement = steer(static_cast<float>(state.rightPaddlePosition.y), ball, aimErrors[1]);
+			const auto delta = milliseconds(random() % 200 == 0 ? 16 + random() % 50 : tick % 3 == 2 ? 9 : 8);
+			game.onInput(input);
+			game.update(delta);
+			Replay::record(match, game, input, delta);
+		}
+		return match;
+	}
+
+	auto record(const char* filename, unsigned int matchCount, unsigned int ticks) -> int {
+		const auto startTime = steady_clock::now();
+		auto writer = Replay::Writer{ filename, matchCount };
+		auto batch = std::vector<Replay::Match>{};
+		for (auto first = 0u; first < matchCount && writer.isGood(); first += BatchSize) {
+			batch.resize(std::min<size_t>(BatchSize, matchCount - first));
+			runParallel(batch.size(), [&](size_t i) { batch[i] = play(static_cast<unsigned int>(first + i), ticks); });
+			for (const auto& match : batch) {
+				writer.write(match);
+			}
+		}
+		if (!writer.isGood()) {
+			std::fprintf(stderr, "cannot write %s\n", filename);
+			return EXIT_FAILURE;
+		}
+		std::printf("recorded %u matches of %u ticks in %.1f s\n", matchCount, ticks,
+			duration<double>(steady_clock::now() - startTime).count());
+		return EXIT_SUCCESS;
+	}
+
+	auto verify(const char* filename) -> int {
+		const auto startTime = steady_clock::now();
+		auto reader = Replay::Reader{ filename };
+		if (!reader.isOpen()) {
+			std::fprintf(stderr, "cannot open a replay corpus: %s\n", filename);
+			return EXIT_FAILURE;
+		}
+
+		// Verify the corpus in batches and report the first diverging tick of each match that plays out differently.
+		auto matches = size_t(0);
+		auto ticks = size_t(0);
+		auto mismatches = size_t(0);
+		auto batch = std::vector<Replay::Match>{};
+		while (matches < reader.getMatchCount()) {
+			batch.clear();
+			if (!reader.read(batch, BatchSize)) {
+				std::fprintf(stderr, "cannot read a replay corpus: %s\n", filename);
+				return EXIT_FAILURE;
+			}
+			for (const auto& mismatch : Replay::verify(batch)) {
+				std::printf("match %zu diverged at tick %zu: expected %016" PRIx64 " got %016" PRIx64 "\n",
+					matches + mismatch.match, mismatch.tick, mismatch.expectedHash, mismatch.actualHash);
+				mismatches++;
+			}
+			for (const auto& match : batch) {
+				ticks += match.ticks.size();
+			}
+			matches += batch.size();
+		}
+
+		const auto time = duration<double>(steady_clock::now() - startTime).count();
+		std::printf("verified %zu matches and %zu ticks in %.1f s (%.1f M ticks/s on %u threads): %zu mismatches\n",
+			matches, ticks, time, ticks / time / 1e6, std::max(1u, std::thread::hardware_concurrency()), mismatches);
+		return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 3) {
+		return usage();
+	}
+	const auto command = std::string{ argv[1] };
+	if (command == "record" && argc <= 5) {
+		const auto matches = argc > 3 ? static_cast<unsigned int>(std::strtoul(argv[3], nullptr, 10)) : DefaultMatches;
+		const auto ticks = argc > 4 ? static_cast<unsigned int>(std::strtoul(argv[4], nullptr, 10)) : DefaultTicks;
+		return record(argv[2], matches, ticks);
+	}
+	if (command == "verify" && argc == 3) {
+		return verify(argv[2]);
+	}
+	return usage();
+}
@@ -0,0 +1,78 @@
+#include "telemetry.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Telemetry;
+using namespace std::chrono;
+
+// Prints aggregates of the events in telemetry logs, optionally with a line for each match:
+//
+//   telemetryquery telemetry.bin --matches
+namespace {
+	auto usage() -> int {
+		std::fprintf(stderr, "usage: telemetryquery FILE... [--matches]\n");
+		return EXIT_FAILURE;
+	}
+
+	void printMatch(const MatchSummary& match) {
+		const auto durationMS = (match.endTimestamp - match.startTimestamp) / 1e6;
+		std::printf("%08x %6u %8llu %6llu %6llu %6llu %6llu %4llu %4llu %9.5f %10.1f\n", match.session, match.match,
+			static_cast<unsigned long long>(match.events),
+			static_cast<unsigned long long>(match.paddleHits[0]), static_cast<unsigned long long>(match.paddleHits[1]),
+			static_cast<unsigned long long>(match.wallBounces[0]), static_cast<unsigned long long>(match.wallBounces[1]),
+			static_cast<unsigned long long>(match.goals[0]), static_cast<unsigned long long>(match.goals[1]),
+			match.maxPaddleHitSpeed, durationMS);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	auto filenames = std::vector<std::string>{};
+	auto matches = false;
+	for (auto i = 1; i < argc; i++) {
+		const auto argument = std::string{ argv[i] };
+		if (argument == "--matches") {
+			matches = true;
+		} else if (argument.rfind("--", 0) == 0) {
+			return usage();
+		} else {
+			filenames.push_back(argument);
+		}
+	}
+	if (filenames.empty()) {
+		return usage();
+	}
+
+	if (matches) {
+		std::printf("%-8s %6s %8s %6s %6s %6s %6s %4s %4s %9s %10s\n", "session", "match", "events", "hits0", "hits1",
+			"walls0", "walls1", "gls0", "gls1", "maxspeed", "ms");
+	}
+	auto summary = Summary{};
+	const auto startTime = steady_clock::now();
+	for (const auto& filename : filenames) {
+		auto onMatch = std::function<void(const MatchSummary&)>{};
+		if (matches) {
+			onMatch = &printMatch;
+		}
+		if (!aggregate(filename, summary, onMatch)) {
+			std::fprintf(stderr, "cannot read a telemetry log: %s\n", filename.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+	const auto time = duration<double>(steady_clock::now() - startTime).count();
+
+	const auto hits = summary.paddleHits[0] + summary.paddleHits[1];
+	std::printf("events=%llu sessions=%llu matches=%llu\n", static_cast<unsigned long long>(summary.events),
+		static_cast<unsigned long long>(summary.sessions), static_cast<unsigned long long>(summary.matches));
+	std::printf("paddle-hits=%llu/%llu wall-bounces=%llu/%llu goals=%llu/%llu\n",
+		static_cast<unsigned long long>(summary.paddleHits[0]), static_cast<unsigned long long>(summary.paddleHits[1]),
+		static_cast<unsigned long long>(summary.wallBounces[0]), static_cast<unsigned long long>(summary.wallBounces[1]),
+		static_cast<unsigned long long>(summary.goals[0]), static_cast<unsigned long long>(summary.goals[1]));
+	std::printf("paddle-hit-speed: mean=%.5f max=%.5f\n", hits > 0 ? summary.totalPaddleHitSpeed / hits : 0.0,
+		summary.maxPaddleHitSpeed);
+	std::printf("time=%.3fs %.1f M events/s\n", time, time > 0.0 ? summary.events / time / 1e6 : 0.0);
+	return EXIT_SUCCESS;
+}
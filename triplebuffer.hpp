@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+
+// TripleBuffer passes the newest value from a single writer to a single reader without locks.
+//
+// The writer fills the back buffer and publishes it by swapping it with the middle buffer. The reader swaps the
+// middle buffer with the front buffer only when a new value has been published, so neither side ever waits.
+template <typename T>
+class TripleBuffer final {
+public:
+	auto getWriteBuffer() -> T& { return buffers[back]; }
+
+	void publish() {
+		back = middle.exchange(back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+	}
+
+	auto read() -> const T& {
+		if (middle.load(std::memory_order_relaxed) & FreshBit) {
+			front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+		}
+		return buffers[front];
+	}
+private:
+	static constexpr auto IndexMask = 0x3;
+	static constexpr auto FreshBit = 0x4;
+
+	T                buffers[3];
+	int              back = 0;
+	std::atomic<int> middle = 1;
+	int              front = 2;
+};
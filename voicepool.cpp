@@ -0,0 +1,26 @@
+#include "voicepool.hpp"
+
+auto VoicePool::schedule(const Samples& playedSamples, uint32_t delay, uint32_t length) -> Playback {
+	// Prefer the voice whose queue drains the latest before the onset so the other voices stay free for longer.
+	auto result = Playback{};
+	auto found = false;
+	auto soonest = UINT64_MAX;
+	for (auto i = 0; i < VoiceCount; i++) {
+		const auto queued = submittedSamples[i] - playedSamples[i];
+		if (queued <= delay && (!found || delay - queued < result.silence)) {
+			result.voice = i;
+			result.silence = static_cast<uint32_t>(delay - queued);
+			found = true;
+		}
+		if (!found && queued < soonest) {
+			result.voice = i;
+			soonest = queued;
+		}
+	}
+	if (!found) {
+		result.silence = 0;
+		result.lateness = static_cast<uint32_t>(soonest - delay);
+	}
+	submittedSamples[result.voice] += result.silence + length;
+	return result;
+}
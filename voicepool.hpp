@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// VoicePool decides which of a few voices of a sound starts the next playback and how much silence precedes it.
+//
+// A voice plays its submitted buffers back to back, so a sound that is submitted while the voice still plays an earlier
+// one would start only after it. The pool tracks the samples submitted to each voice and compares them with the samples
+// the mixer has played to find a voice that drains before the requested onset. Only the remaining gap is padded with
+// silence. When every voice is busy past the onset, the voice that drains first is used and the sound starts late.
+class VoicePool final {
+public:
+	static constexpr auto VoiceCount = 4;
+
+	using Samples = std::array<uint64_t, VoiceCount>;
+
+	struct Playback {
+		int      voice = 0;
+		uint32_t silence = 0;
+		uint32_t lateness = 0;
+	};
+
+	// Plans a playback of the given length that starts the given number of samples from now.
+	auto schedule(const Samples& playedSamples, uint32_t delay, uint32_t length) -> Playback;
+private:
+	Samples submittedSamples = {};
+};